@@ -0,0 +1,118 @@
+#include "ShowdownCommandletUtils.h"
+#include "Engine/Engine.h"
+#include "Engine/LevelStreaming.h"
+#include "Engine/World.h"
+#include "HAL/PlatformFileManager.h"
+#include "ISourceControlModule.h"
+#include "Misc/PackageName.h"
+#include "Misc/Paths.h"
+#include "SourceControlHelpers.h"
+#include "UObject/Package.h"
+#include "UObject/SavePackage.h"
+#include "UObject/UObjectGlobals.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShowdownCommandlet, Log, All);
+
+TArray<FString> ShowdownCommandletUtils::ParseListSwitch(const FString& Params, const TCHAR* Switch, const TArray<FString>& Defaults)
+{
+    FString Value;
+    if (!FParse::Value(*Params, *FString::Printf(TEXT("%s="), Switch), Value, false))
+    {
+        return Defaults;
+    }
+
+    TArray<FString> Values;
+    Value.ParseIntoArray(Values, TEXT("+"), true);
+    return Values;
+}
+
+UWorld* ShowdownCommandletUtils::LoadWorld(const FString& MapPackageName, bool bLoadSublevels, bool bCreatePhysicsScene)
+{
+    UPackage* Package = LoadPackage(nullptr, *MapPackageName, LOAD_None);
+    UWorld* World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+    if (!World)
+    {
+        UE_LOG(LogShowdownCommandlet, Error, TEXT("Failed to load map: %s"), *MapPackageName);
+        return nullptr;
+    }
+
+    World->AddToRoot();
+    World->WorldType = EWorldType::Editor;
+
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Editor);
+    WorldContext.SetCurrentWorld(World);
+
+    if (!World->bIsWorldInitialized)
+    {
+        World->InitWorld(UWorld::InitializationValues()
+            .ShouldSimulatePhysics(false)
+            .EnableTraceCollision(bCreatePhysicsScene)
+            .CreatePhysicsScene(bCreatePhysicsScene)
+            .CreateNavigation(false)
+            .CreateAISystem(false)
+            .AllowAudioPlayback(false)
+            .RequiresHitProxies(false)
+            .SetTransactional(false));
+    }
+    World->UpdateWorldComponents(true, false);
+
+    if (bLoadSublevels)
+    {
+        for (ULevelStreaming* StreamingLevel : World->GetStreamingLevels())
+        {
+            if (StreamingLevel)
+            {
+                StreamingLevel->SetShouldBeLoaded(true);
+                StreamingLevel->SetShouldBeVisible(true);
+            }
+        }
+        World->FlushLevelStreaming(EFlushLevelStreamingType::Full);
+    }
+
+    return World;
+}
+
+void ShowdownCommandletUtils::UnloadWorld(UWorld* World)
+{
+    if (!World)
+    {
+        return;
+    }
+
+    World->DestroyWorld(false);
+    GEngine->DestroyWorldContext(World);
+    World->RemoveFromRoot();
+    CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+}
+
+bool ShowdownCommandletUtils::SavePackage(UPackage* Package, UObject* Asset)
+{
+    const FString& Extension = Asset->IsA<UWorld>() ? FPackageName::GetMapPackageExtension() : FPackageName::GetAssetPackageExtension();
+    const FString Filename = FPaths::ConvertRelativePathToFull(FPackageName::LongPackageNameToFilename(Package->GetName(), Extension));
+
+    if (ISourceControlModule::Get().IsEnabled())
+    {
+        // Checking out up front puts the change in the user's pending changelist so it can be reviewed before submit.
+        USourceControlHelpers::CheckOutOrAddFile(Filename, true);
+    }
+
+    FSavePackageArgs SaveArgs;
+    SaveArgs.TopLevelFlags = RF_Public | RF_Standalone;
+    SaveArgs.SaveFlags = SAVE_NoError;
+
+    if (!UPackage::SavePackage(Package, Asset, *Filename, SaveArgs))
+    {
+        UE_LOG(LogShowdownCommandlet, Error, TEXT("Failed to save package %s to %s"), *Package->GetName(), *Filename);
+        return false;
+    }
+
+    UE_LOG(LogShowdownCommandlet, Display, TEXT("Saved %s"), *Filename);
+    return true;
+}
+
+FString ShowdownCommandletUtils::GetReportDirectory(const FString& Subdirectory)
+{
+    const FString Directory = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("Reports") / Subdirectory) + TEXT("/");
+    FPlatformFileManager::Get().GetPlatformFile().CreateDirectoryTree(*Directory);
+    return Directory;
+}
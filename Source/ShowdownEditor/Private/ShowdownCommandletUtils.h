@@ -0,0 +1,39 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UPackage;
+class UWorld;
+
+/** Helpers shared by the Showdown editor commandlets for loading, saving and reporting on maps. */
+namespace ShowdownCommandletUtils
+{
+    /**
+     * Splits a "-Switch=A+B+C" style value from the commandlet params, falling back to the given defaults.
+     * @param Params The raw commandlet parameter string.
+     * @param Switch The switch name, without leading dash or trailing equals sign.
+     * @param Defaults The values returned when the switch is not present.
+     */
+    TArray<FString> ParseListSwitch(const FString& Params, const TCHAR* Switch, const TArray<FString>& Defaults);
+
+    /**
+     * Loads a map package and initializes its world so actors can be spawned and traced against.
+     * @param MapPackageName Long package name of the map, e.g. /Game/Maps/Showdown_P.
+     * @param bLoadSublevels Also load every streaming level referenced by the map.
+     * @param bCreatePhysicsScene Register collision so line traces work against the level geometry.
+     * @return The initialized world, or nullptr if the package could not be loaded.
+     */
+    UWorld* LoadWorld(const FString& MapPackageName, bool bLoadSublevels, bool bCreatePhysicsScene);
+
+    /** Tears down a world created by LoadWorld and lets it be garbage collected. */
+    void UnloadWorld(UWorld* World);
+
+    /**
+     * Saves a package to its on-disk file, checking it out or marking it for add first when source control is enabled.
+     * @return true if the package was written.
+     */
+    bool SavePackage(UPackage* Package, UObject* Asset);
+
+    /** Returns Saved/Reports/<Subdirectory>/, creating it if needed. */
+    FString GetReportDirectory(const FString& Subdirectory);
+}
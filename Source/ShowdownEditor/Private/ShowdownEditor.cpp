@@ -17,16 +17,21 @@
 #include "EditorUtilitySubsystem.h"
 #include "EditorUtilityWidgetBlueprint.h"
 #include <ShowdownWidgetBase.h>
+#include "Tests/ShowdownBenchmarkHarness.h"
 
 // The DEFINE macro goes here and ONLY here.
 //DEFINE_LOG_CATEGORY_STATIC(LogShowdownEditor, Log, All);
 
+LLM_DEFINE_TAG(Showdown_Editor, TEXT("ShowdownEditor"), TEXT("Showdown"));
+
 #define LOCTEXT_NAMESPACE "FShowdownEditorModule"
 
 // NOTE: I am moving your CreateMaskedImage function into this file, as it doesn't belong to a class.
 // If it is a member function of FShowdownEditorModule, its definition should start with FShowdownEditorModule::
 FString CreateMaskedImage(const FString& OriginalImagePath)
 {
+    LLM_SCOPE_BYTAG(Showdown_Editor);
+
     TArray<uint8> FileData;
     if (!FFileHelper::LoadFileToArray(FileData, *OriginalImagePath))
     {
@@ -114,6 +119,12 @@ UShowdownWidgetBase* GetActiveShowdownWidget()
 
 void FShowdownEditorModule::StartupModule()
 {
+    LLM_SCOPE_BYTAG(Showdown_Editor);
+
+#if WITH_DEV_AUTOMATION_TESTS
+    ShowdownBenchmark::InstallAllocationCounter();
+#endif
+
     FShowdownEditorCommands::Register();
     PluginCommands = MakeShareable(new FUICommandList);
 
@@ -235,6 +246,8 @@ void FShowdownEditorModule::OnCaptureScenePressed()
 
 void FShowdownEditorModule::ExecuteCaptureAndEdit(const FString& Prompt)
 {
+    LLM_SCOPE_BYTAG(Showdown_Editor);
+
     if (CachedScreenshotPath.IsEmpty())
     {
         UE_LOG(LogTemp, Error, TEXT("Execute called but there is no valid cached screenshot path."));
@@ -283,6 +296,8 @@ void FShowdownEditorModule::ExecuteCaptureAndEdit(const FString& Prompt)
 
 void FShowdownEditorModule::OnImageDownloaded(FHttpRequestPtr Request, FHttpResponsePtr Response, bool bWasSuccessful)
 {
+    LLM_SCOPE_BYTAG(Showdown_Editor);
+
     if (bWasSuccessful && Response.IsValid())
     {
         TArray<uint8> ImageData = Response->GetContent();
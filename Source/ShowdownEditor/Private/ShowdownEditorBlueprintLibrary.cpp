@@ -25,6 +25,8 @@ void UShowdownEditorBlueprintLibrary::TriggerSceneEditWithPrompt(const FString&
 
 UTexture2D* UShowdownEditorBlueprintLibrary::LoadTextureFromFile(const FString& FilePath)
 {
+    LLM_SCOPE_BYTAG(Showdown_Editor);
+
     if (!FPaths::FileExists(FilePath))
     {
         UE_LOG(LogTemp, Error, TEXT("LoadTextureFromFile: File not found at path: %s"), *FilePath);
@@ -0,0 +1,480 @@
+#include "ShowdownHISMConversionCommandlet.h"
+#include "ShowdownCommandletUtils.h"
+#include "ShowdownEditor.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "Engine/CollisionProfile.h"
+#include "Engine/Level.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/World.h"
+#include "LevelSequence.h"
+#include "Materials/MaterialInterface.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "MovieScene.h"
+#include "MovieSceneBindingReferences.h"
+#include "UObject/UObjectGlobals.h"
+#include "UniversalObjectLocator.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShowdownHISM, Log, All);
+
+namespace
+{
+    const FName NoHISMTag(TEXT("NoHISM"));
+    const FName ConvertedHISMTag(TEXT("ShowdownHISM"));
+
+    /**
+     * Actors can only be merged when every property that ends up on the shared component matches. Anything the
+     * component carries that is not listed here must be at its default value (see HasOnlyDefaultSettings).
+     */
+    struct FHISMGroupKey
+    {
+        UStaticMesh* Mesh = nullptr;
+        TArray<UMaterialInterface*> Materials;
+        FName CollisionProfile;
+        ECollisionEnabled::Type CollisionEnabled = ECollisionEnabled::QueryAndPhysics;
+        ECollisionChannel CollisionObjectType = ECC_WorldStatic;
+        FCollisionResponseContainer CollisionResponses;
+        bool bCastShadow = true;
+        bool bReceivesDecals = true;
+        bool bVisibleInReflectionCaptures = true;
+        bool bRenderCustomDepth = false;
+        int32 CustomDepthStencilValue = 0;
+        uint8 LightingChannels = 0;
+        int32 ForcedLodModel = 0;
+        int32 MinLOD = INDEX_NONE;
+        int32 TranslucencySortPriority = 0;
+        float MinDrawDistance = 0.0f;
+
+        bool operator==(const FHISMGroupKey& Other) const
+        {
+            return Mesh == Other.Mesh
+                && Materials == Other.Materials
+                && CollisionProfile == Other.CollisionProfile
+                && CollisionEnabled == Other.CollisionEnabled
+                && CollisionObjectType == Other.CollisionObjectType
+                && CollisionResponses == Other.CollisionResponses
+                && bCastShadow == Other.bCastShadow
+                && bReceivesDecals == Other.bReceivesDecals
+                && bVisibleInReflectionCaptures == Other.bVisibleInReflectionCaptures
+                && bRenderCustomDepth == Other.bRenderCustomDepth
+                && CustomDepthStencilValue == Other.CustomDepthStencilValue
+                && LightingChannels == Other.LightingChannels
+                && ForcedLodModel == Other.ForcedLodModel
+                && MinLOD == Other.MinLOD
+                && TranslucencySortPriority == Other.TranslucencySortPriority
+                && MinDrawDistance == Other.MinDrawDistance;
+        }
+
+        friend uint32 GetTypeHash(const FHISMGroupKey& Key)
+        {
+            uint32 Hash = HashCombine(GetTypeHash(Key.Mesh), GetTypeHash(Key.CollisionProfile));
+            for (const UMaterialInterface* Material : Key.Materials)
+            {
+                Hash = HashCombine(Hash, GetTypeHash(Material));
+            }
+            Hash = HashCombine(Hash, FCrc::MemCrc32(Key.CollisionResponses.EnumArray, sizeof(Key.CollisionResponses.EnumArray)));
+            Hash = HashCombine(Hash, GetTypeHash(Key.CustomDepthStencilValue));
+            Hash = HashCombine(Hash, GetTypeHash(Key.ForcedLodModel) ^ (GetTypeHash(Key.MinLOD) << 8) ^ (GetTypeHash(Key.TranslucencySortPriority) << 16));
+            Hash = HashCombine(Hash, GetTypeHash(Key.MinDrawDistance));
+            return HashCombine(Hash, (Key.bCastShadow ? 1u : 0u) | (Key.bReceivesDecals ? 2u : 0u) | (Key.bVisibleInReflectionCaptures ? 4u : 0u)
+                | (Key.bRenderCustomDepth ? 8u : 0u) | (uint32(Key.LightingChannels) << 4) | (uint32(Key.CollisionEnabled) << 8) | (uint32(Key.CollisionObjectType) << 16));
+        }
+    };
+
+    struct FMapConversionStats
+    {
+        int32 PrimitivesBefore = 0;
+        int32 PrimitivesAfter = 0;
+        int32 DrawCallsBefore = 0;
+        int32 DrawCallsAfter = 0;
+        int32 GroupsConverted = 0;
+        int32 ActorsConverted = 0;
+    };
+
+    TArray<ULevelSequence*> LoadLevelSequences()
+    {
+        IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+        AssetRegistry.SearchAllAssets(true);
+
+        TArray<FAssetData> SequenceAssets;
+        AssetRegistry.GetAssetsByClass(ULevelSequence::StaticClass()->GetClassPathName(), SequenceAssets);
+
+        TArray<ULevelSequence*> Sequences;
+        for (const FAssetData& AssetData : SequenceAssets)
+        {
+            if (ULevelSequence* Sequence = Cast<ULevelSequence>(AssetData.GetAsset()))
+            {
+                Sequences.Add(Sequence);
+            }
+        }
+        return Sequences;
+    }
+
+    /**
+     * Every object in World that a level sequence binding resolves to; converting those would break the binding.
+     * Resolved through the binding references rather than by display name, since bindings are free to be renamed.
+     */
+    TSet<const UObject*> GatherSequenceBoundObjects(const TArray<ULevelSequence*>& Sequences, UWorld* World)
+    {
+        TSet<const UObject*> BoundObjects;
+        for (const ULevelSequence* Sequence : Sequences)
+        {
+            for (const FMovieSceneBindingReference& Reference : Sequence->BindingReferences.GetAllReferences())
+            {
+                const UObject* Bound = Reference.Locator.SyncFind(World);
+                if (const UActorComponent* Component = Cast<UActorComponent>(Bound))
+                {
+                    Bound = Component->GetOwner();
+                }
+                if (Bound)
+                {
+                    BoundObjects.Add(Bound);
+                }
+            }
+        }
+        return BoundObjects;
+    }
+
+    /** Everything in the level that some other actor (including the level script actor) holds a pointer to. */
+    TSet<const UObject*> GatherReferencedObjects(ULevel* Level)
+    {
+        TArray<UObject*> Referenced;
+        FReferenceFinder Finder(Referenced, nullptr, false, true, true, true);
+        for (AActor* Actor : Level->Actors)
+        {
+            if (Actor && Actor->GetClass() != AStaticMeshActor::StaticClass())
+            {
+                Finder.FindReferences(Actor);
+            }
+        }
+        TSet<const UObject*> ReferencedSet;
+        ReferencedSet.Append(Referenced);
+        return ReferencedSet;
+    }
+
+    /** Settings FHISMGroupKey does not carry over; an actor that changed any of them cannot be merged without losing it. */
+    bool HasOnlyDefaultSettings(const UStaticMeshComponent* Component)
+    {
+        // Compare with the component an unmodified placed AStaticMeshActor gets, not the bare component class defaults.
+        const UStaticMeshComponent* Defaults = GetDefault<AStaticMeshActor>()->GetStaticMeshComponent();
+        return Component->bOverrideLightMapRes == Defaults->bOverrideLightMapRes
+            && Component->BoundsScale == Defaults->BoundsScale
+            && Component->bRenderInMainPass == Defaults->bRenderInMainPass
+            && Component->bRenderInDepthPass == Defaults->bRenderInDepthPass
+            && Component->bAffectDynamicIndirectLighting == Defaults->bAffectDynamicIndirectLighting
+            && Component->bCastDynamicShadow == Defaults->bCastDynamicShadow
+            && Component->bCastStaticShadow == Defaults->bCastStaticShadow
+            && Component->bCastHiddenShadow == Defaults->bCastHiddenShadow
+            && Component->bVisibleInRayTracing == Defaults->bVisibleInRayTracing
+            && Component->bVisibleInSceneCaptureOnly == Defaults->bVisibleInSceneCaptureOnly
+            && Component->bHiddenInSceneCapture == Defaults->bHiddenInSceneCapture
+            && Component->CustomDepthStencilWriteMask == Defaults->CustomDepthStencilWriteMask
+            && Component->CanCharacterStepUpOn == Defaults->CanCharacterStepUpOn;
+    }
+
+    bool IsConvertible(const AStaticMeshActor* Actor, const TSet<const UObject*>& ReferencedObjects, const TSet<const UObject*>& SequenceBoundObjects)
+    {
+        const UStaticMeshComponent* Component = Actor->GetStaticMeshComponent();
+        if (!Component || !Component->GetStaticMesh() || Component->Mobility != EComponentMobility::Static)
+        {
+            return false;
+        }
+
+        if (Actor->ActorHasTag(NoHISMTag) || Actor->IsHidden() || Actor->IsEditorOnly() || Actor->GetAttachParentActor())
+        {
+            return false;
+        }
+
+        TArray<AActor*> AttachedActors;
+        Actor->GetAttachedActors(AttachedActors);
+        if (AttachedActors.Num() > 0)
+        {
+            return false;
+        }
+
+        // Per-component data that has no per-instance equivalent would be lost in the merge.
+        if (Component->GetCustomPrimitiveData().Data.Num() > 0 || !HasOnlyDefaultSettings(Component))
+        {
+            return false;
+        }
+        for (const FStaticMeshComponentLODInfo& LODInfo : Component->LODData)
+        {
+            if (LODInfo.OverrideVertexColors)
+            {
+                return false;
+            }
+        }
+
+        if (ReferencedObjects.Contains(Actor) || ReferencedObjects.Contains(Component))
+        {
+            return false;
+        }
+
+        return !SequenceBoundObjects.Contains(Actor);
+    }
+
+    FHISMGroupKey MakeGroupKey(const UStaticMeshComponent* Component)
+    {
+        FHISMGroupKey Key;
+        Key.Mesh = Component->GetStaticMesh();
+        for (int32 Index = 0; Index < Component->GetNumMaterials(); ++Index)
+        {
+            Key.Materials.Add(Component->GetMaterial(Index));
+        }
+        Key.CollisionProfile = Component->GetCollisionProfileName();
+        Key.CollisionEnabled = Component->GetCollisionEnabled();
+        Key.CollisionObjectType = Component->GetCollisionObjectType();
+        Key.CollisionResponses = Component->GetCollisionResponseToChannels();
+        Key.bCastShadow = Component->CastShadow;
+        Key.bReceivesDecals = Component->bReceivesDecals;
+        Key.bVisibleInReflectionCaptures = Component->bVisibleInReflectionCaptures;
+        Key.bRenderCustomDepth = Component->bRenderCustomDepth;
+        Key.CustomDepthStencilValue = Component->CustomDepthStencilValue;
+        Key.LightingChannels = (Component->LightingChannels.bChannel0 ? 1 : 0) | (Component->LightingChannels.bChannel1 ? 2 : 0) | (Component->LightingChannels.bChannel2 ? 4 : 0);
+        Key.ForcedLodModel = Component->ForcedLodModel;
+        Key.MinLOD = Component->bOverrideMinLOD ? Component->MinLOD : INDEX_NONE;
+        Key.TranslucencySortPriority = Component->TranslucencySortPriority;
+        Key.MinDrawDistance = Component->MinDrawDistance;
+        return Key;
+    }
+
+    int32 GetDrawCallsPerPrimitive(const UStaticMesh* Mesh)
+    {
+        return FMath::Max(1, Mesh->GetNumSections(0));
+    }
+
+    /**
+     * Picks the distance at which an instance covers less than CullScreenSize of a 90 degree view, unless the
+     * source actors already specified a max draw distance, in which case the most generous one is kept.
+     */
+    float ComputeCullDistance(const FHISMGroupKey& Key, const TArray<AStaticMeshActor*>& Actors, float CullScreenSize, float MinCullDistance)
+    {
+        float AuthoredDistance = 0.0f;
+        float MaxScale = 0.0f;
+        bool bAllAuthored = true;
+        for (const AStaticMeshActor* Actor : Actors)
+        {
+            const float MaxDrawDistance = Actor->GetStaticMeshComponent()->LDMaxDrawDistance;
+            bAllAuthored &= MaxDrawDistance > 0.0f;
+            AuthoredDistance = FMath::Max(AuthoredDistance, MaxDrawDistance);
+            MaxScale = FMath::Max<float>(MaxScale, Actor->GetActorScale3D().GetAbsMax());
+        }
+
+        if (bAllAuthored)
+        {
+            return AuthoredDistance;
+        }
+
+        const float BoundsRadius = Key.Mesh->GetBounds().SphereRadius * MaxScale;
+        return FMath::Max(MinCullDistance, BoundsRadius / FMath::Max(CullScreenSize, KINDA_SMALL_NUMBER));
+    }
+
+    FString DescribeMaterials(const TArray<UMaterialInterface*>& Materials)
+    {
+        TArray<FString> Names;
+        for (const UMaterialInterface* Material : Materials)
+        {
+            Names.Add(Material ? Material->GetName() : TEXT("None"));
+        }
+        return FString::Join(Names, TEXT("|"));
+    }
+}
+
+UShowdownHISMConversionCommandlet::UShowdownHISMConversionCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = true;
+    LogToConsole = true;
+
+    HelpDescription = TEXT("Converts repeated static mesh actors into hierarchical instanced static mesh components.");
+    HelpUsage = TEXT("-run=ShowdownHISMConversion [-Maps=A+B] [-MinInstances=3] [-CullScreenSize=0.01] [-MinCullDistance=1500] [-Save]");
+}
+
+int32 UShowdownHISMConversionCommandlet::Main(const FString& Params)
+{
+    LLM_SCOPE_BYTAG(Showdown_Editor);
+
+    const TArray<FString> Maps = ShowdownCommandletUtils::ParseListSwitch(Params, TEXT("Maps"), { TEXT("/Game/Maps/Showdown_P"), TEXT("/Game/Maps/EnvironmentMap") });
+
+    int32 MinInstances = 3;
+    float CullScreenSize = 0.01f;
+    float MinCullDistance = 1500.0f;
+    FParse::Value(*Params, TEXT("MinInstances="), MinInstances);
+    FParse::Value(*Params, TEXT("CullScreenSize="), CullScreenSize);
+    FParse::Value(*Params, TEXT("MinCullDistance="), MinCullDistance);
+    MinInstances = FMath::Max(2, MinInstances);
+    const bool bSave = FParse::Param(*Params, TEXT("Save"));
+
+    const TArray<ULevelSequence*> Sequences = LoadLevelSequences();
+    const FString ReportDirectory = ShowdownCommandletUtils::GetReportDirectory(TEXT("HISMConversion"));
+
+    TArray<FString> SummaryLines;
+    SummaryLines.Add(TEXT("Map,ActorsConverted,GroupsCreated,PrimitivesBefore,PrimitivesAfter,DrawCallsBefore,DrawCallsAfter,DrawCallReduction"));
+
+    int32 Result = 0;
+    for (const FString& MapName : Maps)
+    {
+        UWorld* World = ShowdownCommandletUtils::LoadWorld(MapName, false, false);
+        if (!World)
+        {
+            Result = 1;
+            continue;
+        }
+
+        ULevel* Level = World->PersistentLevel;
+        const TSet<const UObject*> ReferencedObjects = GatherReferencedObjects(Level);
+        const TSet<const UObject*> SequenceBoundObjects = GatherSequenceBoundObjects(Sequences, World);
+
+        FMapConversionStats Stats;
+        TMap<FHISMGroupKey, TArray<AStaticMeshActor*>> Groups;
+
+        for (AActor* Actor : Level->Actors)
+        {
+            AStaticMeshActor* MeshActor = Cast<AStaticMeshActor>(Actor);
+            if (!MeshActor || !MeshActor->GetStaticMeshComponent() || !MeshActor->GetStaticMeshComponent()->GetStaticMesh())
+            {
+                continue;
+            }
+
+            const UStaticMeshComponent* Component = MeshActor->GetStaticMeshComponent();
+            Stats.PrimitivesBefore++;
+            Stats.DrawCallsBefore += GetDrawCallsPerPrimitive(Component->GetStaticMesh());
+
+            if (MeshActor->GetClass() == AStaticMeshActor::StaticClass() && IsConvertible(MeshActor, ReferencedObjects, SequenceBoundObjects))
+            {
+                Groups.FindOrAdd(MakeGroupKey(Component)).Add(MeshActor);
+            }
+        }
+
+        TArray<FString> GroupLines;
+        GroupLines.Add(TEXT("Mesh,Materials,Instances,DrawCallsBefore,DrawCallsAfter,StartCullDistance,EndCullDistance,ReplacedActors"));
+
+        Stats.PrimitivesAfter = Stats.PrimitivesBefore;
+        Stats.DrawCallsAfter = Stats.DrawCallsBefore;
+
+        for (const TPair<FHISMGroupKey, TArray<AStaticMeshActor*>>& Group : Groups)
+        {
+            const FHISMGroupKey& Key = Group.Key;
+            const TArray<AStaticMeshActor*>& Actors = Group.Value;
+            if (Actors.Num() < MinInstances)
+            {
+                continue;
+            }
+
+            const int32 DrawCallsPerPrimitive = GetDrawCallsPerPrimitive(Key.Mesh);
+            const float EndCullDistance = ComputeCullDistance(Key, Actors, CullScreenSize, MinCullDistance);
+            const float StartCullDistance = EndCullDistance * 0.85f;
+
+            Stats.GroupsConverted++;
+            Stats.ActorsConverted += Actors.Num();
+            Stats.PrimitivesAfter -= Actors.Num() - 1;
+            Stats.DrawCallsAfter -= DrawCallsPerPrimitive * (Actors.Num() - 1);
+
+            FVector Centroid = FVector::ZeroVector;
+            TArray<FTransform> InstanceTransforms;
+            TArray<FString> ActorLabels;
+            for (const AStaticMeshActor* Actor : Actors)
+            {
+                InstanceTransforms.Add(Actor->GetStaticMeshComponent()->GetComponentTransform());
+                Centroid += Actor->GetActorLocation();
+                ActorLabels.Add(Actor->GetActorLabel());
+            }
+            Centroid /= Actors.Num();
+
+            GroupLines.Add(FString::Printf(TEXT("%s,%s,%d,%d,%d,%.0f,%.0f,%s"),
+                *Key.Mesh->GetPathName(), *DescribeMaterials(Key.Materials), Actors.Num(),
+                DrawCallsPerPrimitive * Actors.Num(), DrawCallsPerPrimitive,
+                StartCullDistance, EndCullDistance, *FString::Join(ActorLabels, TEXT("|"))));
+
+            if (!bSave)
+            {
+                continue;
+            }
+
+            const FString ActorName = FString::Printf(TEXT("HISM_%s"), *Key.Mesh->GetName());
+            FActorSpawnParameters SpawnParams;
+            SpawnParams.OverrideLevel = Level;
+            SpawnParams.Name = MakeUniqueObjectName(Level, AActor::StaticClass(), FName(*ActorName));
+            AActor* HISMActor = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform::Identity, SpawnParams);
+
+            UHierarchicalInstancedStaticMeshComponent* HISM = NewObject<UHierarchicalInstancedStaticMeshComponent>(HISMActor, TEXT("HISM"), RF_Transactional);
+            HISM->SetMobility(EComponentMobility::Static);
+            HISM->SetRelativeLocation(Centroid);
+            HISMActor->SetRootComponent(HISM);
+            HISMActor->AddInstanceComponent(HISM);
+
+            HISM->SetStaticMesh(Key.Mesh);
+            for (int32 Index = 0; Index < Key.Materials.Num(); ++Index)
+            {
+                HISM->SetMaterial(Index, Key.Materials[Index]);
+            }
+            HISM->SetCollisionProfileName(Key.CollisionProfile);
+            if (Key.CollisionProfile == UCollisionProfile::CustomCollisionProfileName)
+            {
+                // A custom profile keeps its settings on the component, so copy them over explicitly.
+                HISM->SetCollisionEnabled(Key.CollisionEnabled);
+                HISM->SetCollisionObjectType(Key.CollisionObjectType);
+                HISM->SetCollisionResponseToChannels(Key.CollisionResponses);
+            }
+            HISM->SetCastShadow(Key.bCastShadow);
+            HISM->SetReceivesDecals(Key.bReceivesDecals);
+            HISM->bVisibleInReflectionCaptures = Key.bVisibleInReflectionCaptures;
+            HISM->SetRenderCustomDepth(Key.bRenderCustomDepth);
+            HISM->SetCustomDepthStencilValue(Key.CustomDepthStencilValue);
+            HISM->SetLightingChannels((Key.LightingChannels & 1) != 0, (Key.LightingChannels & 2) != 0, (Key.LightingChannels & 4) != 0);
+            HISM->SetForcedLodModel(Key.ForcedLodModel);
+            if (Key.MinLOD != INDEX_NONE)
+            {
+                HISM->OverrideMinLOD(Key.MinLOD);
+            }
+            HISM->SetTranslucentSortPriority(Key.TranslucencySortPriority);
+            HISM->MinDrawDistance = Key.MinDrawDistance;
+            HISM->SetCullDistances(FMath::RoundToInt(StartCullDistance), FMath::RoundToInt(EndCullDistance));
+            HISM->RegisterComponent();
+            HISM->AddInstances(InstanceTransforms, false, true);
+
+            HISMActor->SetActorLabel(ActorName);
+            HISMActor->SetFolderPath(TEXT("HISM"));
+            HISMActor->Tags.Add(ConvertedHISMTag);
+
+            for (AStaticMeshActor* Actor : Actors)
+            {
+                World->EditorDestroyActor(Actor, false);
+            }
+        }
+
+        const int32 DrawCallReduction = Stats.DrawCallsBefore - Stats.DrawCallsAfter;
+        UE_LOG(LogShowdownHISM, Display, TEXT("%s: %d actors -> %d HISM components. Primitives %d -> %d, estimated draw calls %d -> %d (-%d)."),
+            *MapName, Stats.ActorsConverted, Stats.GroupsConverted, Stats.PrimitivesBefore, Stats.PrimitivesAfter,
+            Stats.DrawCallsBefore, Stats.DrawCallsAfter, DrawCallReduction);
+
+        if (bSave && Stats.GroupsConverted > 0)
+        {
+            if (Level->MapBuildData)
+            {
+                UE_LOG(LogShowdownHISM, Warning, TEXT("%s has precomputed lighting; rebuild lighting before submitting the converted map."), *MapName);
+            }
+
+            if (!ShowdownCommandletUtils::SavePackage(World->GetOutermost(), World))
+            {
+                Result = 1;
+            }
+        }
+
+        SummaryLines.Add(FString::Printf(TEXT("%s,%d,%d,%d,%d,%d,%d,%d"), *MapName, Stats.ActorsConverted, Stats.GroupsConverted,
+            Stats.PrimitivesBefore, Stats.PrimitivesAfter, Stats.DrawCallsBefore, Stats.DrawCallsAfter, DrawCallReduction));
+        FFileHelper::SaveStringArrayToFile(GroupLines, *(ReportDirectory + FPackageName::GetShortName(MapName) + TEXT("_Groups.csv")));
+
+        ShowdownCommandletUtils::UnloadWorld(World);
+    }
+
+    const FString SummaryPath = ReportDirectory + TEXT("Summary.csv");
+    FFileHelper::SaveStringArrayToFile(SummaryLines, *SummaryPath);
+    UE_LOG(LogShowdownHISM, Display, TEXT("HISM conversion report written to %s%s"), *SummaryPath, bSave ? TEXT("") : TEXT(" (dry run, pass -Save to apply)"));
+
+    return Result;
+}
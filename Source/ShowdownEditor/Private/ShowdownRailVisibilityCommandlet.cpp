@@ -0,0 +1,913 @@
+#include "ShowdownRailVisibilityCommandlet.h"
+#include "ShowdownCommandletUtils.h"
+#include "ShowdownEditor.h"
+#include "ShowdownRailVisibilityData.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Async/ParallelFor.h"
+#include "CameraRig_Rail.h"
+#include "Channels/MovieSceneDoubleChannel.h"
+#include "Channels/MovieSceneFloatChannel.h"
+#include "Compilation/MovieSceneCompiledDataManager.h"
+#include "Components/BrushComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Components/SplineComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "Evaluation/MovieSceneSequenceHierarchy.h"
+#include "GameFramework/Volume.h"
+#include "HAL/PlatformAtomics.h"
+#include "LevelSequence.h"
+#include "Materials/MaterialInterface.h"
+#include "Misc/FileHelper.h"
+#include "Misc/PackageName.h"
+#include "MovieScene.h"
+#include "MovieSceneBindingReferences.h"
+#include "Sections/MovieScene3DAttachSection.h"
+#include "Sections/MovieScene3DTransformSection.h"
+#include "Sections/MovieSceneCameraCutSection.h"
+#include "Sections/MovieSceneCinematicShotSection.h"
+#include "Sections/MovieSceneSubSection.h"
+#include "Tracks/MovieScene3DAttachTrack.h"
+#include "Tracks/MovieScene3DTransformTrack.h"
+#include "Tracks/MovieSceneCameraCutTrack.h"
+#include "Tracks/MovieScenePropertyTrack.h"
+#include "Tracks/MovieSceneSubTrack.h"
+#include "UObject/Package.h"
+#include "UniversalObjectLocator.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShowdownRailVisibility, Log, All);
+
+namespace
+{
+    /** Primitives larger than this (sky spheres, ground planes) are visible from everywhere and left out of the bake. */
+    const double MaxPrimitiveExtent = 50000.0;
+
+    /** Length of the rays cast in every direction from the camera to catch large surfaces between sample points. */
+    const double MaxSweepDistance = 100000.0;
+
+    /** Deepest chain of sub-sequences or attach parents followed when locating the camera. */
+    const int32 MaxEvaluationDepth = 8;
+
+    /** Non-occluders a single ray may pass through before it is given up on and treated as unblocked. */
+    const int32 MaxPassThroughHits = 16;
+
+    struct FCameraSample
+    {
+        FVector Location = FVector::ZeroVector;
+        FName Shot;
+    };
+
+    struct FBakePrimitive
+    {
+        UPrimitiveComponent* Component = nullptr;
+        FBox Bounds;
+        TArray<FVector, TInlineAllocator<15>> Targets;
+    };
+
+    /** Static geometry that actually hides what is behind it at runtime. */
+    using FOccluderSet = TSet<const UPrimitiveComponent*>;
+
+    struct FShotStats
+    {
+        int32 Segments = 0;
+        int64 CulledTotal = 0;
+        int32 CulledMin = MAX_int32;
+        int32 CulledMax = 0;
+    };
+
+    /** A binding within a sequence hierarchy: the sub-sequence it belongs to and its GUID there. */
+    struct FBinding
+    {
+        FMovieSceneSequenceID SequenceID = MovieSceneSequenceID::Root;
+        FGuid Guid;
+
+        bool IsValid() const
+        {
+            return Guid.IsValid();
+        }
+
+        bool operator==(const FBinding& Other) const
+        {
+            return SequenceID == Other.SequenceID && Guid == Other.Guid;
+        }
+
+        friend uint32 GetTypeHash(const FBinding& Binding)
+        {
+            return HashCombine(GetTypeHash(Binding.SequenceID), GetTypeHash(Binding.Guid));
+        }
+    };
+
+    /** Locates the active camera of a level sequence at a given time, offline, without playing the sequence. */
+    class FCameraPathEvaluator
+    {
+    public:
+        FCameraPathEvaluator(UWorld* InWorld, UMovieSceneSequence* InRootSequence)
+            : World(InWorld)
+            , RootSequence(InRootSequence)
+        {
+            // The same hierarchy Sequencer builds, so sequence IDs and time transforms match playback.
+            FMovieSceneCompiledDataManager::CompileHierarchy(RootSequence, &Hierarchy, EMovieSceneServerClientMask::All);
+        }
+
+        /**
+         * Camera location at RootTime. When a camera cut is active but its binding cannot be placed, returns false
+         * with OutUnresolvedCamera naming it.
+         */
+        bool Evaluate(FFrameTime RootTime, FCameraSample& OutSample, FString& OutUnresolvedCamera) const
+        {
+            return EvaluateSequence(MovieSceneSequenceID::Root, RootTime, OutSample, OutUnresolvedCamera, 0);
+        }
+
+    private:
+        const UMovieSceneSequence* GetSequence(FMovieSceneSequenceID SequenceID) const
+        {
+            return SequenceID == MovieSceneSequenceID::Root ? RootSequence : Hierarchy.FindSubSequence(SequenceID);
+        }
+
+        const UMovieScene* GetMovieScene(FMovieSceneSequenceID SequenceID) const
+        {
+            const UMovieSceneSequence* Sequence = GetSequence(SequenceID);
+            return Sequence ? Sequence->GetMovieScene() : nullptr;
+        }
+
+        FFrameTime GetLocalTime(FMovieSceneSequenceID SequenceID, FFrameTime RootTime) const
+        {
+            const FMovieSceneSubSequenceData* SubData = SequenceID == MovieSceneSequenceID::Root ? nullptr : Hierarchy.FindSubData(SequenceID);
+            return SubData ? SubData->RootToSequenceTransform.TransformTime(RootTime) : RootTime;
+        }
+
+        /** A binding ID as seen from SourceID, which may point into a parent or child sequence. */
+        FBinding Resolve(const FMovieSceneObjectBindingID& BindingID, FMovieSceneSequenceID SourceID) const
+        {
+            return FBinding{ BindingID.ResolveSequenceID(SourceID, &Hierarchy), BindingID.GetGuid() };
+        }
+
+        bool EvaluateSequence(FMovieSceneSequenceID SequenceID, FFrameTime RootTime, FCameraSample& OutSample, FString& OutUnresolvedCamera, int32 Depth) const
+        {
+            const UMovieSceneSequence* Sequence = GetSequence(SequenceID);
+            const UMovieScene* MovieScene = Sequence ? Sequence->GetMovieScene() : nullptr;
+            if (!MovieScene || Depth > MaxEvaluationDepth)
+            {
+                return false;
+            }
+
+            const FFrameNumber Frame = GetLocalTime(SequenceID, RootTime).FloorToFrame();
+
+            // Shots and sub-sequences own the camera while they play, so look inside them first.
+            for (const UMovieSceneTrack* Track : MovieScene->GetTracks())
+            {
+                const UMovieSceneSubTrack* SubTrack = Cast<UMovieSceneSubTrack>(Track);
+                if (!SubTrack || SubTrack->IsEvalDisabled())
+                {
+                    continue;
+                }
+
+                for (const UMovieSceneSection* Section : SubTrack->GetAllSections())
+                {
+                    const UMovieSceneSubSection* SubSection = Cast<UMovieSceneSubSection>(Section);
+                    if (!SubSection || !SubSection->IsActive() || !SubSection->GetRange().Contains(Frame))
+                    {
+                        continue;
+                    }
+
+                    if (EvaluateSequence(SubSection->GetSequenceID().AccumulateParentID(SequenceID), RootTime, OutSample, OutUnresolvedCamera, Depth + 1))
+                    {
+                        if (const UMovieSceneCinematicShotSection* ShotSection = Cast<UMovieSceneCinematicShotSection>(SubSection))
+                        {
+                            OutSample.Shot = FName(*ShotSection->GetShotDisplayName());
+                        }
+                        return true;
+                    }
+                }
+            }
+
+            const UMovieSceneCameraCutTrack* CameraCutTrack = Cast<UMovieSceneCameraCutTrack>(MovieScene->GetCameraCutTrack());
+            if (!CameraCutTrack)
+            {
+                return false;
+            }
+
+            for (const UMovieSceneSection* Section : CameraCutTrack->GetAllSections())
+            {
+                const UMovieSceneCameraCutSection* CameraCut = Cast<UMovieSceneCameraCutSection>(Section);
+                if (!CameraCut || !CameraCut->IsActive() || !CameraCut->GetRange().Contains(Frame))
+                {
+                    continue;
+                }
+
+                const FBinding Camera = Resolve(CameraCut->GetCameraBindingID(), SequenceID);
+                const FString CameraName = FString::Printf(TEXT("%s:%s"), *Sequence->GetName(), *GetBindingName(Camera));
+                FTransform CameraTransform;
+                if (EvaluateBinding(Camera, RootTime, CameraTransform, Depth))
+                {
+                    OutSample.Location = CameraTransform.GetLocation();
+                    OutSample.Shot = FName(*CameraName);
+                    return true;
+                }
+                OutUnresolvedCamera = CameraName;
+            }
+            return false;
+        }
+
+        FString GetBindingName(const FBinding& Binding) const
+        {
+            if (const UMovieScene* MovieScene = GetMovieScene(Binding.SequenceID))
+            {
+                if (const FMovieScenePossessable* Possessable = MovieScene->FindPossessable(Binding.Guid))
+                {
+                    return Possessable->GetName();
+                }
+                if (const FMovieSceneSpawnable* Spawnable = MovieScene->FindSpawnable(Binding.Guid))
+                {
+                    return Spawnable->GetName();
+                }
+            }
+            return Binding.Guid.ToString();
+        }
+
+        /**
+         * What a binding resolves to in the loaded world, through the sequence's own binding references: an actor or
+         * component for possessables, the object template for spawnables.
+         */
+        const UObject* FindBoundObject(const FBinding& Binding, int32 Depth = 0) const
+        {
+            if (const UObject* const* Cached = BoundObjects.Find(Binding))
+            {
+                return *Cached;
+            }
+
+            const UObject* Bound = nullptr;
+            const UMovieSceneSequence* Sequence = GetSequence(Binding.SequenceID);
+            const UMovieScene* MovieScene = Sequence ? Sequence->GetMovieScene() : nullptr;
+            if (MovieScene && Depth <= MaxEvaluationDepth)
+            {
+                if (const FMovieSceneSpawnable* Spawnable = MovieScene->FindSpawnable(Binding.Guid))
+                {
+                    Bound = Spawnable->GetObjectTemplate();
+                }
+                else if (const FMovieScenePossessable* Possessable = MovieScene->FindPossessable(Binding.Guid))
+                {
+                    // Component bindings are located relative to what their parent binding resolves to.
+                    UObject* Context = World;
+                    if (Possessable->GetParent().IsValid())
+                    {
+                        Context = const_cast<UObject*>(FindBoundObject(FBinding{ Binding.SequenceID, Possessable->GetParent() }, Depth + 1));
+                    }
+
+                    const ULevelSequence* LevelSequence = Cast<ULevelSequence>(Sequence);
+                    if (Context && LevelSequence)
+                    {
+                        for (const FMovieSceneBindingReference& Reference : LevelSequence->BindingReferences.GetReferences(Binding.Guid))
+                        {
+                            Bound = Reference.Locator.SyncFind(Context);
+                            if (Bound)
+                            {
+                                break;
+                            }
+                        }
+                    }
+                }
+            }
+
+            BoundObjects.Add(Binding, Bound);
+            return Bound;
+        }
+
+        static const AActor* GetActor(const UObject* Object)
+        {
+            const UActorComponent* Component = Cast<UActorComponent>(Object);
+            return Component ? Component->GetOwner() : Cast<AActor>(Object);
+        }
+
+        /** Binding in the given sequence that resolves to Actor, if any. */
+        FBinding FindBinding(FMovieSceneSequenceID SequenceID, const AActor* Actor) const
+        {
+            if (const UMovieScene* MovieScene = GetMovieScene(SequenceID))
+            {
+                for (int32 Index = 0; Index < MovieScene->GetPossessableCount(); ++Index)
+                {
+                    const FBinding Binding{ SequenceID, MovieScene->GetPossessable(Index).GetGuid() };
+                    if (FindBoundObject(Binding) == Actor)
+                    {
+                        return Binding;
+                    }
+                }
+            }
+            return FBinding();
+        }
+
+        bool EvaluateTransformTrack(const FBinding& Binding, FFrameTime RootTime, FTransform& OutTransform) const
+        {
+            const UMovieScene* MovieScene = GetMovieScene(Binding.SequenceID);
+            const UMovieScene3DTransformTrack* Track = MovieScene ? MovieScene->FindTrack<UMovieScene3DTransformTrack>(Binding.Guid) : nullptr;
+            if (!Track)
+            {
+                return false;
+            }
+
+            const FFrameTime Time = GetLocalTime(Binding.SequenceID, RootTime);
+            for (const UMovieSceneSection* Section : Track->GetAllSections())
+            {
+                if (!Section->IsActive() || !Section->GetRange().Contains(Time.FloorToFrame()))
+                {
+                    continue;
+                }
+
+                // Location XYZ, rotation roll/pitch/yaw, scale XYZ.
+                TArrayView<FMovieSceneDoubleChannel* const> Channels = Section->GetChannelProxy().GetChannels<FMovieSceneDoubleChannel>();
+                double Values[9] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 1.0, 1.0, 1.0 };
+                for (int32 Index = 0; Index < FMath::Min(Channels.Num(), 9); ++Index)
+                {
+                    Channels[Index]->Evaluate(Time, Values[Index]);
+                }
+
+                OutTransform = FTransform(FRotator(Values[4], Values[5], Values[3]), FVector(Values[0], Values[1], Values[2]), FVector(Values[6], Values[7], Values[8]));
+                return true;
+            }
+            return false;
+        }
+
+        bool EvaluateScalarProperty(const FBinding& Binding, FName PropertyName, FFrameTime RootTime, float& OutValue) const
+        {
+            const UMovieScene* MovieScene = GetMovieScene(Binding.SequenceID);
+            const FMovieSceneBinding* SceneBinding = MovieScene ? MovieScene->FindBinding(Binding.Guid) : nullptr;
+            if (!SceneBinding)
+            {
+                return false;
+            }
+
+            const FFrameTime Time = GetLocalTime(Binding.SequenceID, RootTime);
+            for (const UMovieSceneTrack* Track : SceneBinding->GetTracks())
+            {
+                const UMovieScenePropertyTrack* PropertyTrack = Cast<UMovieScenePropertyTrack>(Track);
+                if (!PropertyTrack || PropertyTrack->GetPropertyName() != PropertyName)
+                {
+                    continue;
+                }
+
+                for (const UMovieSceneSection* Section : PropertyTrack->GetAllSections())
+                {
+                    if (!Section->IsActive() || !Section->GetRange().Contains(Time.FloorToFrame()))
+                    {
+                        continue;
+                    }
+
+                    TArrayView<FMovieSceneFloatChannel* const> FloatChannels = Section->GetChannelProxy().GetChannels<FMovieSceneFloatChannel>();
+                    if (FloatChannels.Num() > 0)
+                    {
+                        return FloatChannels[0]->Evaluate(Time, OutValue);
+                    }
+
+                    TArrayView<FMovieSceneDoubleChannel* const> DoubleChannels = Section->GetChannelProxy().GetChannels<FMovieSceneDoubleChannel>();
+                    double Value = OutValue;
+                    if (DoubleChannels.Num() > 0 && DoubleChannels[0]->Evaluate(Time, Value))
+                    {
+                        OutValue = float(Value);
+                        return true;
+                    }
+                }
+            }
+            return false;
+        }
+
+        /** Binding a 3D attach track attaches Binding to at the given time, if any. */
+        FBinding FindAttachParent(const FBinding& Binding, FFrameTime RootTime) const
+        {
+            const UMovieScene* MovieScene = GetMovieScene(Binding.SequenceID);
+            const UMovieScene3DAttachTrack* Track = MovieScene ? MovieScene->FindTrack<UMovieScene3DAttachTrack>(Binding.Guid) : nullptr;
+            if (!Track)
+            {
+                return FBinding();
+            }
+
+            const FFrameNumber Frame = GetLocalTime(Binding.SequenceID, RootTime).FloorToFrame();
+            for (const UMovieSceneSection* Section : Track->GetAllSections())
+            {
+                const UMovieScene3DAttachSection* AttachSection = Cast<UMovieScene3DAttachSection>(Section);
+                if (AttachSection && AttachSection->IsActive() && AttachSection->GetRange().Contains(Frame))
+                {
+                    return Resolve(AttachSection->GetConstraintBindingID(), Binding.SequenceID);
+                }
+            }
+            return FBinding();
+        }
+
+        /** World transform of the rail's camera mount, with the rig's own animation and the rail position applied. */
+        bool EvaluateRailMount(const FBinding& RailBinding, const ACameraRig_Rail* Rail, FFrameTime RootTime, int32 Depth, FTransform& OutTransform) const
+        {
+            ACameraRig_Rail* MutableRail = const_cast<ACameraRig_Rail*>(Rail);
+            const USplineComponent* Spline = MutableRail->GetRailSplineComponent();
+            const USceneComponent* Mount = MutableRail->GetDefaultAttachComponent();
+            if (!Spline || !Mount)
+            {
+                return false;
+            }
+
+            float Position = Rail->CurrentPositionOnRail;
+            FTransform RigTransform = Rail->GetActorTransform();
+            if (RailBinding.IsValid())
+            {
+                EvaluateScalarProperty(RailBinding, GET_MEMBER_NAME_CHECKED(ACameraRig_Rail, CurrentPositionOnRail), RootTime, Position);
+                EvaluateBinding(RailBinding, RootTime, RigTransform, Depth + 1);
+            }
+
+            // Same placement as ACameraRig_Rail::UpdateRailComponents, done in rig space so an animated rig moves the rail too.
+            const FTransform SplineTransform = Spline->GetRelativeTransform() * RigTransform;
+            const FTransform OnRail = Spline->GetTransformAtDistanceAlongSpline(Position * Spline->GetSplineLength(), ESplineCoordinateSpace::Local) * SplineTransform;
+            const FQuat Rotation = Rail->bLockOrientationToRail ? OnRail.GetRotation() : RigTransform.GetRotation() * Mount->GetRelativeRotation().Quaternion();
+            OutTransform = FTransform(Rotation, OnRail.GetLocation());
+            return true;
+        }
+
+        /** World transform of an attach parent given by its binding, its level actor, or both. */
+        bool EvaluateParent(const FBinding& ParentBinding, const AActor* ParentActor, FFrameTime RootTime, int32 Depth, FTransform& OutTransform) const
+        {
+            if (const ACameraRig_Rail* Rail = Cast<ACameraRig_Rail>(ParentActor))
+            {
+                if (EvaluateRailMount(ParentBinding, Rail, RootTime, Depth, OutTransform))
+                {
+                    return true;
+                }
+            }
+
+            if (ParentBinding.IsValid() && EvaluateBinding(ParentBinding, RootTime, OutTransform, Depth + 1))
+            {
+                return true;
+            }
+
+            if (ParentActor)
+            {
+                OutTransform = ParentActor->GetActorTransform();
+                return true;
+            }
+            return false;
+        }
+
+        bool EvaluateBinding(const FBinding& Binding, FFrameTime RootTime, FTransform& OutTransform, int32 Depth) const
+        {
+            const UMovieScene* MovieScene = GetMovieScene(Binding.SequenceID);
+            if (!MovieScene || Depth > MaxEvaluationDepth)
+            {
+                return false;
+            }
+
+            FGuid OwnerGuid;
+            if (const FMovieScenePossessable* Possessable = MovieScene->FindPossessable(Binding.Guid))
+            {
+                OwnerGuid = Possessable->GetParent();
+            }
+            else if (!MovieScene->FindSpawnable(Binding.Guid))
+            {
+                return false;
+            }
+
+            const UObject* Bound = FindBoundObject(Binding);
+            const AActor* Actor = Cast<AActor>(Bound);
+            const USceneComponent* SceneComponent = Actor ? Actor->GetRootComponent() : Cast<USceneComponent>(Bound);
+
+            // An active attach track wins over the owning binding and the level attachment, as it does in Sequencer.
+            FTransform ParentTransform;
+            bool bHasParent = false;
+            const FBinding AttachBinding = FindAttachParent(Binding, RootTime);
+            if (AttachBinding.IsValid())
+            {
+                bHasParent = EvaluateParent(AttachBinding, GetActor(FindBoundObject(AttachBinding)), RootTime, Depth, ParentTransform);
+            }
+            else if (OwnerGuid.IsValid())
+            {
+                bHasParent = EvaluateBinding(FBinding{ Binding.SequenceID, OwnerGuid }, RootTime, ParentTransform, Depth + 1);
+            }
+            else if (Actor && Actor->GetAttachParentActor())
+            {
+                const AActor* ParentActor = Actor->GetAttachParentActor();
+                bHasParent = EvaluateParent(FindBinding(Binding.SequenceID, ParentActor), ParentActor, RootTime, Depth, ParentTransform);
+            }
+
+            FTransform LocalTransform;
+            if (!EvaluateTransformTrack(Binding, RootTime, LocalTransform))
+            {
+                if (SceneComponent)
+                {
+                    LocalTransform = bHasParent ? SceneComponent->GetRelativeTransform() : SceneComponent->GetComponentTransform();
+                }
+                else if (!bHasParent)
+                {
+                    return false;
+                }
+            }
+
+            OutTransform = bHasParent ? LocalTransform * ParentTransform : LocalTransform;
+            return true;
+        }
+
+        UWorld* World = nullptr;
+        UMovieSceneSequence* RootSequence = nullptr;
+        FMovieSceneSequenceHierarchy Hierarchy;
+
+        /** Resolving a locator can search the world, so each binding is only resolved once per sequence. */
+        mutable TMap<FBinding, const UObject*> BoundObjects;
+    };
+
+    bool IsStaticAndVisible(const AActor* Actor, const UPrimitiveComponent* Component)
+    {
+        return Component->IsRegistered() && Component->Mobility == EComponentMobility::Static && Component->IsVisible()
+            && !Component->bHiddenInGame && !Component->IsEditorOnly() && !Actor->IsHidden() && !Actor->IsEditorOnly();
+    }
+
+    /** Only opaque, rendered, static geometry may hide anything; volumes, brushes, glass and masked cutouts do not. */
+    bool IsOccluder(const AActor* Actor, const UPrimitiveComponent* Component)
+    {
+        if (!IsStaticAndVisible(Actor, Component) || Component->IsA<UBrushComponent>() || Actor->IsA<AVolume>())
+        {
+            return false;
+        }
+
+        const int32 NumMaterials = Component->GetNumMaterials();
+        for (int32 Index = 0; Index < NumMaterials; ++Index)
+        {
+            const UMaterialInterface* Material = Component->GetMaterial(Index);
+            if (!Material || Material->GetBlendMode() != BLEND_Opaque)
+            {
+                return false;
+            }
+        }
+        return NumMaterials > 0;
+    }
+
+    /**
+     * Static, visible primitives of every loaded level, with the points rays are cast at, and the subset of all
+     * static geometry (including primitives too large to bake) that is allowed to block those rays.
+     */
+    TArray<FBakePrimitive> GatherPrimitives(UWorld* World, FOccluderSet& OutOccluders)
+    {
+        TArray<FBakePrimitive> Primitives;
+        for (ULevel* Level : World->GetLevels())
+        {
+            for (AActor* Actor : Level->Actors)
+            {
+                if (!Actor)
+                {
+                    continue;
+                }
+
+                TInlineComponentArray<UPrimitiveComponent*> Components(Actor);
+                for (UPrimitiveComponent* Component : Components)
+                {
+                    if (IsOccluder(Actor, Component))
+                    {
+                        OutOccluders.Add(Component);
+                    }
+
+                    if (!IsStaticAndVisible(Actor, Component))
+                    {
+                        continue;
+                    }
+
+                    const FBox Bounds = Component->Bounds.GetBox();
+                    if (!Bounds.IsValid || Bounds.GetExtent().GetMax() > MaxPrimitiveExtent)
+                    {
+                        continue;
+                    }
+
+                    FBakePrimitive& Primitive = Primitives.AddDefaulted_GetRef();
+                    Primitive.Component = Component;
+                    Primitive.Bounds = Bounds;
+
+                    // Pull the points slightly inside the box so rays end in the primitive rather than grazing its surface.
+                    const FVector Center = Bounds.GetCenter();
+                    const FVector Extent = Bounds.GetExtent() * 0.9;
+                    Primitive.Targets.Add(Center);
+                    for (int32 Corner = 0; Corner < 8; ++Corner)
+                    {
+                        Primitive.Targets.Add(Center + Extent * FVector((Corner & 1) ? 1.0 : -1.0, (Corner & 2) ? 1.0 : -1.0, (Corner & 4) ? 1.0 : -1.0));
+                    }
+                    for (int32 Axis = 0; Axis < 3; ++Axis)
+                    {
+                        FVector Offset = FVector::ZeroVector;
+                        Offset[Axis] = Extent[Axis];
+                        Primitive.Targets.Add(Center + Offset);
+                        Primitive.Targets.Add(Center - Offset);
+                    }
+                }
+            }
+        }
+        return Primitives;
+    }
+
+    /**
+     * Finds the first occluder between Start and End. Anything else with visibility collision (movable actors at
+     * their placed position, volumes, translucent or masked meshes...) is reported to OnPassThrough and skipped.
+     */
+    bool FindOccluderHit(const UWorld* World, const FVector& Start, const FVector& End, const FOccluderSet& Occluders, FHitResult& OutHit,
+        TFunctionRef<void(const UPrimitiveComponent*)> OnPassThrough)
+    {
+        FCollisionQueryParams QueryParams(TEXT("ShowdownRailVisibility"), true);
+        for (int32 Pass = 0; Pass < MaxPassThroughHits; ++Pass)
+        {
+            if (!World->LineTraceSingleByChannel(OutHit, Start, End, ECC_Visibility, QueryParams))
+            {
+                return false;
+            }
+
+            const UPrimitiveComponent* Component = OutHit.GetComponent();
+            if (Occluders.Contains(Component))
+            {
+                return true;
+            }
+
+            OnPassThrough(Component);
+            QueryParams.AddIgnoredComponent(Component);
+        }
+        return false;
+    }
+
+    bool IsVisibleFrom(const UWorld* World, const FBakePrimitive& Primitive, const TArray<FVector>& Eyes, const FOccluderSet& Occluders, float HeadRadius)
+    {
+        const FBox EyeBounds = Primitive.Bounds.ExpandBy(HeadRadius);
+        const FBox HitBounds = Primitive.Bounds.ExpandBy(1.0);
+
+        for (const FVector& Eye : Eyes)
+        {
+            if (EyeBounds.IsInside(Eye))
+            {
+                return true;
+            }
+
+            for (const FVector& Target : Primitive.Targets)
+            {
+                FHitResult Hit;
+                if (!FindOccluderHit(World, Eye, Target, Occluders, Hit, [](const UPrimitiveComponent*) {})
+                    || Hit.GetComponent() == Primitive.Component
+                    || HitBounds.IsInside(Hit.ImpactPoint))
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Several ParallelFor tasks set bits in the same words, so every access during the bake is atomic.
+    void MarkVisible(TArray<uint32>& VisibleBits, int32 Index)
+    {
+        FPlatformAtomics::InterlockedOr(reinterpret_cast<volatile int32*>(&VisibleBits[Index / 32]), int32(1u << (Index % 32)));
+    }
+
+    bool IsMarkedVisible(const TArray<uint32>& VisibleBits, int32 Index)
+    {
+        return (FPlatformAtomics::AtomicRead(reinterpret_cast<const volatile int32*>(&VisibleBits[Index / 32])) & int32(1u << (Index % 32))) != 0;
+    }
+
+    /** Evenly spread unit directions (Fibonacci sphere) for the omnidirectional sweep. */
+    TArray<FVector> MakeSweepDirections(int32 Count)
+    {
+        TArray<FVector> Directions;
+        Directions.Reserve(Count);
+        const double GoldenAngle = PI * (3.0 - FMath::Sqrt(5.0));
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            const double Z = 1.0 - 2.0 * (Index + 0.5) / Count;
+            const double Radius = FMath::Sqrt(1.0 - Z * Z);
+            const double Angle = GoldenAngle * Index;
+            Directions.Add(FVector(Radius * FMath::Cos(Angle), Radius * FMath::Sin(Angle), Z));
+        }
+        return Directions;
+    }
+
+    FString GetObjectPath(const FString& Path)
+    {
+        return Path.Contains(TEXT(".")) ? Path : Path + TEXT(".") + FPackageName::GetShortName(Path);
+    }
+}
+
+UShowdownRailVisibilityCommandlet::UShowdownRailVisibilityCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = true;
+    LogToConsole = true;
+
+    HelpDescription = TEXT("Bakes per-time-segment visible primitive sets along the rail camera path of level sequences.");
+    HelpUsage = TEXT("-run=ShowdownRailVisibility [-Map=/Game/Maps/Showdown_P] [-Sequences=A+B] [-OutputPath=/Game/Visibility] [-SegmentSeconds=0.5] [-SamplesPerSegment=3] [-HeadRadius=40] [-SweepRays=2048]");
+}
+
+int32 UShowdownRailVisibilityCommandlet::Main(const FString& Params)
+{
+    LLM_SCOPE_BYTAG(Showdown_Editor);
+
+    FString MapName = TEXT("/Game/Maps/Showdown_P");
+    FString OutputPath = TEXT("/Game/Visibility");
+    float SegmentSeconds = 0.5f;
+    int32 SamplesPerSegment = 3;
+    float HeadRadius = 40.0f;
+    int32 SweepRays = 2048;
+    FParse::Value(*Params, TEXT("Map="), MapName);
+    FParse::Value(*Params, TEXT("OutputPath="), OutputPath);
+    FParse::Value(*Params, TEXT("SegmentSeconds="), SegmentSeconds);
+    FParse::Value(*Params, TEXT("SamplesPerSegment="), SamplesPerSegment);
+    FParse::Value(*Params, TEXT("HeadRadius="), HeadRadius);
+    FParse::Value(*Params, TEXT("SweepRays="), SweepRays);
+    SegmentSeconds = FMath::Max(SegmentSeconds, 0.05f);
+    SamplesPerSegment = FMath::Max(SamplesPerSegment, 2);
+
+    const TArray<FString> Sequences = ShowdownCommandletUtils::ParseListSwitch(Params, TEXT("Sequences"),
+        { TEXT("/Game/MatineeSequences/SequenceMaster"), TEXT("/Game/MatineeSequences/SlomoRail_LevelSequence") });
+
+    UWorld* World = ShowdownCommandletUtils::LoadWorld(MapName, true, true);
+    if (!World)
+    {
+        return 1;
+    }
+
+    FOccluderSet Occluders;
+    const TArray<FBakePrimitive> Primitives = GatherPrimitives(World, Occluders);
+    TMap<const UPrimitiveComponent*, int32> PrimitiveIndices;
+    for (int32 Index = 0; Index < Primitives.Num(); ++Index)
+    {
+        PrimitiveIndices.Add(Primitives[Index].Component, Index);
+    }
+    UE_LOG(LogShowdownRailVisibility, Display, TEXT("%s: %d static primitives considered for culling, %d occluders"), *MapName, Primitives.Num(), Occluders.Num());
+
+    const TArray<FVector> SweepDirections = MakeSweepDirections(SweepRays);
+    const FVector HeadOffsets[] = { FVector::ZeroVector, FVector::ForwardVector, FVector::BackwardVector, FVector::RightVector, FVector::LeftVector, FVector::UpVector, FVector::DownVector };
+    const FString ReportDirectory = ShowdownCommandletUtils::GetReportDirectory(TEXT("RailVisibility"));
+
+    int32 Result = 0;
+    for (const FString& SequencePath : Sequences)
+    {
+        ULevelSequence* Sequence = LoadObject<ULevelSequence>(nullptr, *GetObjectPath(SequencePath));
+        const UMovieScene* MovieScene = Sequence ? Sequence->GetMovieScene() : nullptr;
+        if (!MovieScene)
+        {
+            UE_LOG(LogShowdownRailVisibility, Error, TEXT("Failed to load level sequence: %s"), *SequencePath);
+            Result = 1;
+            continue;
+        }
+
+        const FCameraPathEvaluator Evaluator(World, Sequence);
+
+        const FFrameRate TickResolution = MovieScene->GetTickResolution();
+        const TRange<FFrameNumber> PlaybackRange = MovieScene->GetPlaybackRange();
+        const double StartSeconds = TickResolution.AsSeconds(UE::MovieScene::DiscreteInclusiveLower(PlaybackRange));
+        const double EndSeconds = TickResolution.AsSeconds(UE::MovieScene::DiscreteExclusiveUpper(PlaybackRange));
+        const int32 NumSegments = FMath::Max(1, FMath::CeilToInt((EndSeconds - StartSeconds) / SegmentSeconds));
+        const int32 NumWords = FMath::DivideAndRoundUp(Primitives.Num(), 32);
+
+        TArray<FShowdownRailVisibilitySegment> Segments;
+        Segments.SetNum(NumSegments);
+        int32 MissingSamples = 0;
+
+        for (int32 SegmentIndex = 0; SegmentIndex < NumSegments; ++SegmentIndex)
+        {
+            FShowdownRailVisibilitySegment& Segment = Segments[SegmentIndex];
+            const double SegmentStart = StartSeconds + SegmentIndex * SegmentSeconds;
+            const double SegmentEnd = FMath::Min(EndSeconds, SegmentStart + SegmentSeconds);
+            Segment.StartTime = float(SegmentStart);
+            Segment.EndTime = float(SegmentEnd);
+            Segment.VisibleBits.Init(0, NumWords);
+
+            TArray<FVector> Eyes;
+            TMap<FName, int32> ShotVotes;
+            FString UnresolvedCamera;
+            for (int32 SampleIndex = 0; SampleIndex < SamplesPerSegment; ++SampleIndex)
+            {
+                const double SampleSeconds = FMath::Lerp(SegmentStart, SegmentEnd, double(SampleIndex) / (SamplesPerSegment - 1));
+                FCameraSample Sample;
+                if (!Evaluator.Evaluate(TickResolution.AsFrameTime(FMath::Min(SampleSeconds, EndSeconds - KINDA_SMALL_NUMBER)), Sample, UnresolvedCamera))
+                {
+                    ++MissingSamples;
+                    continue;
+                }
+
+                ShotVotes.FindOrAdd(Sample.Shot)++;
+                for (const FVector& Offset : HeadOffsets)
+                {
+                    Eyes.Add(Sample.Location + Offset * HeadRadius);
+                }
+            }
+
+            if (Eyes.Num() == 0)
+            {
+                // Without a camera location nothing can be proven hidden.
+                Segment.VisibleBits.Init(MAX_uint32, NumWords);
+                UE_LOG(LogShowdownRailVisibility, Warning, TEXT("%s: %.2fs-%.2fs keeps everything visible, %s."), *SequencePath, SegmentStart, SegmentEnd,
+                    UnresolvedCamera.IsEmpty() ? TEXT("no camera cut is active") : *FString::Printf(TEXT("camera %s could not be located"), *UnresolvedCamera));
+                continue;
+            }
+
+            ShotVotes.ValueSort(TGreater<int32>());
+            Segment.ShotName = ShotVotes.CreateConstIterator().Key();
+
+            // Omnidirectional sweep first: cheap, and catches large surfaces whose sample points happen to be hidden.
+            for (int32 EyeIndex = 0; EyeIndex < Eyes.Num(); EyeIndex += UE_ARRAY_COUNT(HeadOffsets))
+            {
+                const FVector Eye = Eyes[EyeIndex];
+                ParallelFor(SweepDirections.Num(), [&](int32 DirectionIndex)
+                    {
+                        auto MarkHit = [&](const UPrimitiveComponent* Component)
+                        {
+                            if (const int32* Index = PrimitiveIndices.Find(Component))
+                            {
+                                MarkVisible(Segment.VisibleBits, *Index);
+                            }
+                        };
+
+                        FHitResult Hit;
+                        if (FindOccluderHit(World, Eye, Eye + SweepDirections[DirectionIndex] * MaxSweepDistance, Occluders, Hit, MarkHit))
+                        {
+                            MarkHit(Hit.GetComponent());
+                        }
+                    });
+            }
+
+            ParallelFor(Primitives.Num(), [&](int32 Index)
+                {
+                    if (!IsMarkedVisible(Segment.VisibleBits, Index) && IsVisibleFrom(World, Primitives[Index], Eyes, Occluders, HeadRadius))
+                    {
+                        MarkVisible(Segment.VisibleBits, Index);
+                    }
+                });
+        }
+
+        // Dilate by one segment each way so primitives appear before the camera can see them rather than on the frame it does.
+        TArray<FShowdownRailVisibilitySegment> Dilated = Segments;
+        for (int32 SegmentIndex = 0; SegmentIndex < NumSegments; ++SegmentIndex)
+        {
+            for (const int32 Neighbour : { SegmentIndex - 1, SegmentIndex + 1 })
+            {
+                if (Segments.IsValidIndex(Neighbour))
+                {
+                    for (int32 Word = 0; Word < NumWords; ++Word)
+                    {
+                        Dilated[SegmentIndex].VisibleBits[Word] |= Segments[Neighbour].VisibleBits[Word];
+                    }
+                }
+            }
+        }
+
+        TMap<FName, FShotStats> ShotStats;
+        for (const FShowdownRailVisibilitySegment& Segment : Dilated)
+        {
+            int32 VisibleCount = 0;
+            for (int32 Index = 0; Index < Primitives.Num(); ++Index)
+            {
+                VisibleCount += Segment.IsVisible(Index) ? 1 : 0;
+            }
+
+            const int32 Culled = Primitives.Num() - VisibleCount;
+            FShotStats& Stats = ShotStats.FindOrAdd(Segment.ShotName);
+            Stats.Segments++;
+            Stats.CulledTotal += Culled;
+            Stats.CulledMin = FMath::Min(Stats.CulledMin, Culled);
+            Stats.CulledMax = FMath::Max(Stats.CulledMax, Culled);
+        }
+
+        TArray<FString> ReportLines;
+        ReportLines.Add(TEXT("Shot,Segments,Primitives,AverageCulled,MinCulled,MaxCulled"));
+        for (const TPair<FName, FShotStats>& Pair : ShotStats)
+        {
+            const double AverageCulled = double(Pair.Value.CulledTotal) / Pair.Value.Segments;
+            ReportLines.Add(FString::Printf(TEXT("%s,%d,%d,%.1f,%d,%d"), *Pair.Key.ToString(), Pair.Value.Segments, Primitives.Num(), AverageCulled, Pair.Value.CulledMin, Pair.Value.CulledMax));
+            UE_LOG(LogShowdownRailVisibility, Display, TEXT("  %s: %.1f of %d primitives culled on average (min %d, max %d) over %d segments"),
+                *Pair.Key.ToString(), AverageCulled, Primitives.Num(), Pair.Value.CulledMin, Pair.Value.CulledMax, Pair.Value.Segments);
+        }
+        FFileHelper::SaveStringArrayToFile(ReportLines, *(ReportDirectory + Sequence->GetName() + TEXT("_Shots.csv")));
+
+        if (MissingSamples > 0)
+        {
+            UE_LOG(LogShowdownRailVisibility, Warning, TEXT("%s: no camera found for %d samples."), *SequencePath, MissingSamples);
+        }
+
+        const FString AssetName = TEXT("RailVisibility_") + Sequence->GetName();
+        UPackage* Package = CreatePackage(*(OutputPath / AssetName));
+        Package->FullyLoad();
+
+        UShowdownRailVisibilityData* Data = FindObject<UShowdownRailVisibilityData>(Package, *AssetName);
+        if (!Data)
+        {
+            Data = NewObject<UShowdownRailVisibilityData>(Package, *AssetName, RF_Public | RF_Standalone);
+            FAssetRegistryModule::AssetCreated(Data);
+        }
+
+        Data->Sequence = FSoftObjectPath(Sequence);
+        Data->Primitives.Reset(Primitives.Num());
+        for (const FBakePrimitive& Primitive : Primitives)
+        {
+            const AActor* Owner = Primitive.Component->GetOwner();
+            FShowdownRailPrimitive& Entry = Data->Primitives.AddDefaulted_GetRef();
+            Entry.LevelName = FName(*FPackageName::GetShortName(Owner->GetLevel()->GetOutermost()->GetName()));
+            Entry.ActorName = Owner->GetFName();
+            Entry.ComponentName = Primitive.Component->GetFName();
+        }
+        Data->Segments = MoveTemp(Dilated);
+        Package->MarkPackageDirty();
+
+        if (!ShowdownCommandletUtils::SavePackage(Package, Data))
+        {
+            Result = 1;
+        }
+    }
+
+    ShowdownCommandletUtils::UnloadWorld(World);
+    return Result;
+}
@@ -0,0 +1,361 @@
+#include "ShowdownShaderPermutationCommandlet.h"
+#include "ShowdownCommandletUtils.h"
+#include "ShowdownEditor.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "HAL/IConsoleManager.h"
+#include "Materials/Material.h"
+#include "Materials/MaterialInstanceConstant.h"
+#include "MaterialShared.h"
+#include "MaterialShaderType.h"
+#include "Misc/FileHelper.h"
+#include "RHI.h"
+#include "Shader.h"
+#include "VertexFactory.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShowdownShaderPermutations, Log, All);
+
+namespace
+{
+    /**
+     * Maps a shader or vertex factory type name (or the policy name embedded in it) to a project setting it needs.
+     * A type that needs several settings has one rule per setting, and is credited to all of them.
+     */
+    struct FSettingRule
+    {
+        const TCHAR* Pattern;
+        const TCHAR* Setting;
+    };
+
+    /** Maps a substring of a vertex factory type name to the material usage flag that requests it. */
+    struct FUsageRule
+    {
+        const TCHAR* Pattern;
+        EMaterialUsage Usage;
+    };
+
+    const FSettingRule SettingRules[] =
+    {
+        { TEXT("FNanite"), TEXT("r.Nanite.ProjectEnabled") },
+        { TEXT("PathTracing"), TEXT("r.PathTracing") },
+        { TEXT("LumenHardwareRayTracingMaterial"), TEXT("r.Lumen.HardwareRayTracing") },
+        { TEXT("LumenHardwareRayTracingMaterial"), TEXT("r.RayTracing") },
+        { TEXT("MaterialCHS"), TEXT("r.RayTracing") },
+        { TEXT("RayHitGroup"), TEXT("r.RayTracing") },
+        { TEXT("FGPUSkinPassthroughVertexFactory"), TEXT("r.SkinCache.CompileShaders") },
+
+        // Mobile base pass light map policies.
+        { TEXT("TLightMapPolicyLQ"), TEXT("r.AllowStaticLighting") },
+        { TEXT("TLightMapPolicyLQ"), TEXT("r.SupportLowQualityLightmaps") },
+        { TEXT("FMobileDistanceFieldShadowsAndLQLightMapPolicy"), TEXT("r.AllowStaticLighting") },
+        { TEXT("FMobileDistanceFieldShadowsAndLQLightMapPolicy"), TEXT("r.SupportLowQualityLightmaps") },
+        { TEXT("FMobileDistanceFieldShadowsAndLQLightMapPolicy"), TEXT("r.Mobile.AllowDistanceFieldShadows") },
+        { TEXT("FMobileDistanceFieldShadowsLightMapAndCSMLightingPolicy"), TEXT("r.AllowStaticLighting") },
+        { TEXT("FMobileDistanceFieldShadowsLightMapAndCSMLightingPolicy"), TEXT("r.SupportLowQualityLightmaps") },
+        { TEXT("FMobileDistanceFieldShadowsLightMapAndCSMLightingPolicy"), TEXT("r.Mobile.AllowDistanceFieldShadows") },
+        { TEXT("FMobileDistanceFieldShadowsLightMapAndCSMLightingPolicy"), TEXT("r.Mobile.EnableStaticAndCSMShadowReceivers") },
+        { TEXT("FMobileDirectionalLightCSMAndLightMapPolicy"), TEXT("r.AllowStaticLighting") },
+        { TEXT("FMobileDirectionalLightCSMAndLightMapPolicy"), TEXT("r.SupportLowQualityLightmaps") },
+        { TEXT("FMobileDirectionalLightCSMAndLightMapPolicy"), TEXT("r.Mobile.EnableStaticAndCSMShadowReceivers") },
+        { TEXT("FMobileDirectionalLightAndSHIndirectPolicy"), TEXT("r.AllowStaticLighting") },
+        { TEXT("FMobileDirectionalLightCSMAndSHIndirectPolicy"), TEXT("r.AllowStaticLighting") },
+        { TEXT("FMobileMovableDirectionalLightWithLightmapPolicy"), TEXT("r.AllowStaticLighting") },
+        { TEXT("FMobileMovableDirectionalLightWithLightmapPolicy"), TEXT("r.SupportLowQualityLightmaps") },
+        { TEXT("FMobileMovableDirectionalLightWithLightmapPolicy"), TEXT("r.Mobile.AllowMovableDirectionalLights") },
+        { TEXT("FMobileMovableDirectionalLightCSMWithLightmapPolicy"), TEXT("r.AllowStaticLighting") },
+        { TEXT("FMobileMovableDirectionalLightCSMWithLightmapPolicy"), TEXT("r.SupportLowQualityLightmaps") },
+        { TEXT("FMobileMovableDirectionalLightCSMWithLightmapPolicy"), TEXT("r.Mobile.AllowMovableDirectionalLights") },
+
+        // Desktop light map policies.
+        { TEXT("TLightMapPolicyHQ"), TEXT("r.AllowStaticLighting") },
+        { TEXT("TDistanceFieldShadowsAndLightMapPolicyHQ"), TEXT("r.AllowStaticLighting") },
+
+        { TEXT("SkyAtmosphere"), TEXT("r.SupportSkyAtmosphere") },
+        { TEXT("HeterogeneousVolume"), TEXT("r.HeterogeneousVolumes") },
+        { TEXT("LocalFogVolume"), TEXT("r.SupportLocalFogVolumes") },
+        { TEXT("FVelocityVS"), TEXT("r.VelocityOutputPass") },
+        { TEXT("FVelocityPS"), TEXT("r.VelocityOutputPass") },
+        { TEXT("TVirtualTexture"), TEXT("r.VirtualTextures") },
+    };
+
+    const FUsageRule UsageRules[] =
+    {
+        { TEXT("GPUSkinAPEXCloth"), MATUSAGE_Clothing },
+        { TEXT("Morph"), MATUSAGE_MorphTargets },
+        { TEXT("GPUSkin"), MATUSAGE_SkeletalMesh },
+        { TEXT("InstancedStaticMesh"), MATUSAGE_InstancedStaticMeshes },
+        { TEXT("SplineMesh"), MATUSAGE_SplineMesh },
+        { TEXT("ParticleSprite"), MATUSAGE_ParticleSprites },
+        { TEXT("ParticleBeamTrail"), MATUSAGE_BeamTrails },
+        { TEXT("MeshParticle"), MATUSAGE_MeshParticles },
+        { TEXT("NiagaraSprite"), MATUSAGE_NiagaraSprites },
+        { TEXT("NiagaraRibbon"), MATUSAGE_NiagaraRibbons },
+        { TEXT("NiagaraMesh"), MATUSAGE_NiagaraMeshParticles },
+        { TEXT("GeometryCache"), MATUSAGE_GeometryCache },
+        { TEXT("Nanite"), MATUSAGE_Nanite },
+        { TEXT("HairStrands"), MATUSAGE_HairStrands },
+        { TEXT("Water"), MATUSAGE_Water },
+    };
+
+    using FSettingList = TArray<const TCHAR*, TInlineAllocator<4>>;
+
+    /** Every setting the type depends on, each listed once. */
+    FSettingList FindSettings(const FString& TypeName)
+    {
+        FSettingList Settings;
+        for (const FSettingRule& Rule : SettingRules)
+        {
+            if (TypeName.Contains(Rule.Pattern) && !Settings.ContainsByPredicate([&Rule](const TCHAR* Setting) { return FCString::Strcmp(Setting, Rule.Setting) == 0; }))
+            {
+                Settings.Add(Rule.Setting);
+            }
+        }
+        return Settings;
+    }
+
+    const FUsageRule* FindUsage(const FString& VertexFactoryName)
+    {
+        for (const FUsageRule& Rule : UsageRules)
+        {
+            if (VertexFactoryName.Contains(Rule.Pattern))
+            {
+                return &Rule;
+            }
+        }
+        return nullptr;
+    }
+
+    FString GetSettingValue(const TCHAR* Setting)
+    {
+        const IConsoleVariable* Variable = IConsoleManager::Get().FindConsoleVariable(Setting);
+        return Variable ? Variable->GetString() : TEXT("n/a");
+    }
+
+    struct FMaterialPermutations
+    {
+        FString MaterialPath;
+        int32 StaticPermutationInstances = 0;
+        int32 MaterialShaders = 0;
+        int32 MeshShaders = 0;
+        int32 VertexFactories = 0;
+
+        /** Every static permutation instance compiles its own copy of the parent's shader map. */
+        int32 GetShaderMapCount() const { return 1 + StaticPermutationInstances; }
+        int64 GetTotal() const { return int64(MaterialShaders + MeshShaders) * GetShaderMapCount(); }
+    };
+
+    struct FFormatReport
+    {
+        TArray<FMaterialPermutations> Materials;
+        TMap<FString, int64> PerVertexFactory;
+        TMap<FString, int64> PerSetting;
+        TMap<FString, int64> PerUsageFlag;
+        int64 Total = 0;
+    };
+
+    /** Instances with static switch overrides keyed by their base material; those are the ones that add shader maps. */
+    TMap<const UMaterial*, int32> CountStaticPermutationInstances(const TArray<FAssetData>& InstanceAssets)
+    {
+        TMap<const UMaterial*, int32> Counts;
+        for (const FAssetData& AssetData : InstanceAssets)
+        {
+            const UMaterialInstanceConstant* Instance = Cast<UMaterialInstanceConstant>(AssetData.GetAsset());
+            if (Instance && Instance->bHasStaticPermutationResource)
+            {
+                Counts.FindOrAdd(Instance->GetMaterial())++;
+            }
+        }
+        return Counts;
+    }
+
+    void AnalyzeMaterial(UMaterial* Material, int32 StaticPermutationInstances, EShaderPlatform ShaderPlatform, FFormatReport& Report)
+    {
+        FMaterialResource* Resource = Material->AllocateResource();
+        Resource->SetMaterial(Material, nullptr, GetMaxSupportedFeatureLevel(ShaderPlatform), EMaterialQualityLevel::High);
+
+        const FMaterialShaderParameters MaterialParameters(Resource);
+        const FMaterialShaderMapLayout& Layout = AcquireMaterialShaderMapLayout(ShaderPlatform, EShaderPermutationFlags::None, MaterialParameters);
+
+        FMaterialPermutations Permutations;
+        Permutations.MaterialPath = Material->GetPathName();
+        Permutations.StaticPermutationInstances = StaticPermutationInstances;
+        Permutations.MaterialShaders = Layout.Shaders.Num();
+        Permutations.VertexFactories = Layout.MeshShaderMaps.Num();
+
+        const int32 ShaderMapCount = Permutations.GetShaderMapCount();
+        for (const FShaderLayoutEntry& Entry : Layout.Shaders)
+        {
+            for (const TCHAR* Setting : FindSettings(Entry.ShaderType->GetName()))
+            {
+                Report.PerSetting.FindOrAdd(Setting) += ShaderMapCount;
+            }
+        }
+
+        for (const FMeshMaterialShaderMapLayout& MeshLayout : Layout.MeshShaderMaps)
+        {
+            const FString VertexFactoryName = MeshLayout.VertexFactoryType->GetName();
+            const int64 Count = int64(MeshLayout.Shaders.Num()) * ShaderMapCount;
+            Permutations.MeshShaders += MeshLayout.Shaders.Num();
+            Report.PerVertexFactory.FindOrAdd(VertexFactoryName) += Count;
+
+            if (const FUsageRule* Usage = FindUsage(VertexFactoryName))
+            {
+                if (Material->GetUsageByFlag(Usage->Usage))
+                {
+                    Report.PerUsageFlag.FindOrAdd(UMaterial::GetUsageName(Usage->Usage)) += Count;
+                }
+            }
+
+            // Every shader of a vertex factory depends on what the factory depends on; shaders add their own on top.
+            const FSettingList VertexFactorySettings = FindSettings(VertexFactoryName);
+            for (const TCHAR* Setting : VertexFactorySettings)
+            {
+                Report.PerSetting.FindOrAdd(Setting) += Count;
+            }
+            for (const FShaderLayoutEntry& Entry : MeshLayout.Shaders)
+            {
+                for (const TCHAR* Setting : FindSettings(Entry.ShaderType->GetName()))
+                {
+                    if (!VertexFactorySettings.ContainsByPredicate([Setting](const TCHAR* Other) { return FCString::Strcmp(Setting, Other) == 0; }))
+                    {
+                        Report.PerSetting.FindOrAdd(Setting) += ShaderMapCount;
+                    }
+                }
+            }
+        }
+
+        Report.Total += Permutations.GetTotal();
+        Report.Materials.Add(MoveTemp(Permutations));
+
+        delete Resource;
+    }
+
+    void WriteReport(const FString& Directory, const FString& ShaderFormat, FFormatReport& Report, int32 AvgShaderBytes, float AvgCompileMs)
+    {
+        auto EstimateColumns = [AvgShaderBytes, AvgCompileMs](int64 Count)
+        {
+            return FString::Printf(TEXT("%.1f,%.1f"), double(Count) * AvgShaderBytes / 1024.0, double(Count) * AvgCompileMs / 1000.0);
+        };
+
+        Report.Materials.Sort([](const FMaterialPermutations& A, const FMaterialPermutations& B) { return A.GetTotal() > B.GetTotal(); });
+        TArray<FString> MaterialLines;
+        MaterialLines.Add(TEXT("Material,StaticPermutationInstances,MaterialShaders,VertexFactories,MeshShaders,TotalPermutations,EstimatedKB,EstimatedCompileSeconds"));
+        for (const FMaterialPermutations& Permutations : Report.Materials)
+        {
+            MaterialLines.Add(FString::Printf(TEXT("%s,%d,%d,%d,%d,%lld,%s"), *Permutations.MaterialPath, Permutations.StaticPermutationInstances,
+                Permutations.MaterialShaders, Permutations.VertexFactories, Permutations.MeshShaders, Permutations.GetTotal(),
+                *EstimateColumns(Permutations.GetTotal())));
+        }
+        FFileHelper::SaveStringArrayToFile(MaterialLines, *(Directory + ShaderFormat + TEXT("_Materials.csv")));
+
+        Report.PerVertexFactory.ValueSort(TGreater<int64>());
+        TArray<FString> VertexFactoryLines;
+        VertexFactoryLines.Add(TEXT("VertexFactory,Permutations,EstimatedKB,EstimatedCompileSeconds"));
+        for (const TPair<FString, int64>& Pair : Report.PerVertexFactory)
+        {
+            VertexFactoryLines.Add(FString::Printf(TEXT("%s,%lld,%s"), *Pair.Key, Pair.Value, *EstimateColumns(Pair.Value)));
+        }
+        FFileHelper::SaveStringArrayToFile(VertexFactoryLines, *(Directory + ShaderFormat + TEXT("_VertexFactories.csv")));
+
+        TArray<FString> SettingLines;
+        SettingLines.Add(TEXT("Setting,CurrentValue,PermutationsDependingOn,EstimatedKB,EstimatedCompileSeconds"));
+        TSet<FString> ReportedSettings;
+        for (const FSettingRule& Rule : SettingRules)
+        {
+            bool bAlreadyReported = false;
+            ReportedSettings.Add(Rule.Setting, &bAlreadyReported);
+            if (bAlreadyReported)
+            {
+                continue;
+            }
+            const int64 Count = Report.PerSetting.FindRef(Rule.Setting);
+            SettingLines.Add(FString::Printf(TEXT("%s,%s,%lld,%s"), Rule.Setting, *GetSettingValue(Rule.Setting), Count, *EstimateColumns(Count)));
+            UE_LOG(LogShowdownShaderPermutations, Display, TEXT("  %s=%s: %lld permutations depend on it"), Rule.Setting, *GetSettingValue(Rule.Setting), Count);
+        }
+        FFileHelper::SaveStringArrayToFile(SettingLines, *(Directory + ShaderFormat + TEXT("_Settings.csv")));
+
+        Report.PerUsageFlag.ValueSort(TGreater<int64>());
+        TArray<FString> UsageLines;
+        UsageLines.Add(TEXT("UsageFlag,PermutationsSavedIfCleared,EstimatedKBSaved,EstimatedCompileSecondsSaved"));
+        for (const TPair<FString, int64>& Pair : Report.PerUsageFlag)
+        {
+            UsageLines.Add(FString::Printf(TEXT("%s,%lld,%s"), *Pair.Key, Pair.Value, *EstimateColumns(Pair.Value)));
+        }
+        FFileHelper::SaveStringArrayToFile(UsageLines, *(Directory + ShaderFormat + TEXT("_UsageFlags.csv")));
+    }
+}
+
+UShowdownShaderPermutationCommandlet::UShowdownShaderPermutationCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = true;
+    LogToConsole = true;
+
+    HelpDescription = TEXT("Counts material shader permutations per target shader format and attributes them to project settings and usage flags.");
+    HelpUsage = TEXT("-run=ShowdownShaderPermutations [-ShaderFormats=SF_VULKAN_ES31_ANDROID+PCD3D_SM5] [-Paths=/Game] [-AvgShaderBytes=6144] [-AvgCompileMs=150]");
+}
+
+int32 UShowdownShaderPermutationCommandlet::Main(const FString& Params)
+{
+    LLM_SCOPE_BYTAG(Showdown_Editor);
+
+    const TArray<FString> ShaderFormats = ShowdownCommandletUtils::ParseListSwitch(Params, TEXT("ShaderFormats"), { TEXT("SF_VULKAN_ES31_ANDROID") });
+    const TArray<FString> Paths = ShowdownCommandletUtils::ParseListSwitch(Params, TEXT("Paths"), { TEXT("/Game") });
+
+    int32 AvgShaderBytes = 6144;
+    float AvgCompileMs = 150.0f;
+    FParse::Value(*Params, TEXT("AvgShaderBytes="), AvgShaderBytes);
+    FParse::Value(*Params, TEXT("AvgCompileMs="), AvgCompileMs);
+
+    IAssetRegistry& AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>(TEXT("AssetRegistry")).Get();
+    AssetRegistry.SearchAllAssets(true);
+
+    FARFilter Filter;
+    Filter.bRecursivePaths = true;
+    for (const FString& Path : Paths)
+    {
+        Filter.PackagePaths.Add(FName(*Path));
+    }
+
+    TArray<FAssetData> MaterialAssets;
+    FARFilter MaterialFilter = Filter;
+    MaterialFilter.ClassPaths.Add(UMaterial::StaticClass()->GetClassPathName());
+    AssetRegistry.GetAssets(MaterialFilter, MaterialAssets);
+
+    TArray<FAssetData> InstanceAssets;
+    FARFilter InstanceFilter = Filter;
+    InstanceFilter.ClassPaths.Add(UMaterialInstanceConstant::StaticClass()->GetClassPathName());
+    AssetRegistry.GetAssets(InstanceFilter, InstanceAssets);
+
+    const TMap<const UMaterial*, int32> StaticPermutationInstances = CountStaticPermutationInstances(InstanceAssets);
+    const FString ReportDirectory = ShowdownCommandletUtils::GetReportDirectory(TEXT("ShaderPermutations"));
+
+    int32 Result = 0;
+    for (const FString& ShaderFormat : ShaderFormats)
+    {
+        const EShaderPlatform ShaderPlatform = ShaderFormatToLegacyShaderPlatform(FName(*ShaderFormat));
+        if (ShaderPlatform == SP_NumPlatforms)
+        {
+            UE_LOG(LogShowdownShaderPermutations, Error, TEXT("Unknown shader format: %s"), *ShaderFormat);
+            Result = 1;
+            continue;
+        }
+
+        FFormatReport Report;
+        for (const FAssetData& AssetData : MaterialAssets)
+        {
+            if (UMaterial* Material = Cast<UMaterial>(AssetData.GetAsset()))
+            {
+                AnalyzeMaterial(Material, StaticPermutationInstances.FindRef(Material), ShaderPlatform, Report);
+            }
+        }
+
+        UE_LOG(LogShowdownShaderPermutations, Display, TEXT("%s: %d materials, %lld shader permutations (~%.1f MB, ~%.0f s compile)."),
+            *ShaderFormat, Report.Materials.Num(), Report.Total, double(Report.Total) * AvgShaderBytes / (1024.0 * 1024.0), double(Report.Total) * AvgCompileMs / 1000.0);
+        WriteReport(ReportDirectory, ShaderFormat, Report, AvgShaderBytes, AvgCompileMs);
+    }
+
+    UE_LOG(LogShowdownShaderPermutations, Display, TEXT("Shader permutation report written to %s"), *ReportDirectory);
+    return Result;
+}
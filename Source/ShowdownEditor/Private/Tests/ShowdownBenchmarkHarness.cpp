@@ -0,0 +1,334 @@
+#include "ShowdownBenchmarkHarness.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Dom/JsonObject.h"
+#include "HAL/MemoryBase.h"
+#include "HAL/PlatformFileManager.h"
+#include "IImageWrapperModule.h"
+#include "Math/RandomStream.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace
+{
+    /** Allowed slowdown of the median time before a benchmark counts as a regression. */
+    const double TimeTolerance = 0.25;
+
+    // Per-thread counters, so the proxy never has to look up or compare thread ids.
+    thread_local bool bCountAllocations = false;
+    thread_local int64 CountedAllocations = 0;
+    thread_local int64 CountedBytes = 0;
+
+    /**
+     * Forwards to the real allocator and counts the calls made by threads that opted in through bCountAllocations.
+     * Installed once at startup by InstallAllocationCounter and never removed or destroyed, so a thread still holding
+     * the previous GMalloc keeps working and no thread can call into a dead proxy.
+     */
+    class FCountingMalloc final : public FMalloc
+    {
+    public:
+        explicit FCountingMalloc(FMalloc* InInner)
+            : Inner(InInner)
+        {
+        }
+
+        virtual void* Malloc(SIZE_T Count, uint32 Alignment) override
+        {
+            Track(Count);
+            return Inner->Malloc(Count, Alignment);
+        }
+
+        virtual void* TryMalloc(SIZE_T Count, uint32 Alignment) override
+        {
+            Track(Count);
+            return Inner->TryMalloc(Count, Alignment);
+        }
+
+        virtual void* Realloc(void* Original, SIZE_T Count, uint32 Alignment) override
+        {
+            if (Count > 0)
+            {
+                Track(Count);
+            }
+            return Inner->Realloc(Original, Count, Alignment);
+        }
+
+        virtual void* TryRealloc(void* Original, SIZE_T Count, uint32 Alignment) override
+        {
+            if (Count > 0)
+            {
+                Track(Count);
+            }
+            return Inner->TryRealloc(Original, Count, Alignment);
+        }
+
+        virtual void Free(void* Original) override { Inner->Free(Original); }
+        virtual SIZE_T QuantizeSize(SIZE_T Count, uint32 Alignment) override { return Inner->QuantizeSize(Count, Alignment); }
+        virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override { return Inner->GetAllocationSize(Original, SizeOut); }
+        virtual void Trim(bool bTrimThreadCaches) override { Inner->Trim(bTrimThreadCaches); }
+        virtual void SetupTLSCachesOnCurrentThread() override { Inner->SetupTLSCachesOnCurrentThread(); }
+        virtual void MarkTLSCachesAsUsedOnCurrentThread() override { Inner->MarkTLSCachesAsUsedOnCurrentThread(); }
+        virtual void MarkTLSCachesAsUnusedOnCurrentThread() override { Inner->MarkTLSCachesAsUnusedOnCurrentThread(); }
+        virtual void ClearAndDisableTLSCachesOnCurrentThread() override { Inner->ClearAndDisableTLSCachesOnCurrentThread(); }
+        virtual void InitializeStatsMetadata() override { Inner->InitializeStatsMetadata(); }
+        virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override { Inner->GetAllocatorStats(OutStats); }
+        virtual void DumpAllocatorStats(FOutputDevice& Ar) override { Inner->DumpAllocatorStats(Ar); }
+        virtual void UpdateStats() override { Inner->UpdateStats(); }
+        virtual void OnMallocInitialized() override { Inner->OnMallocInitialized(); }
+        virtual void OnPreFork() override { Inner->OnPreFork(); }
+        virtual void OnPostFork() override { Inner->OnPostFork(); }
+        virtual bool IsInternallyThreadSafe() const override { return Inner->IsInternallyThreadSafe(); }
+        virtual bool ValidateHeap() override { return Inner->ValidateHeap(); }
+        virtual const TCHAR* GetDescriptiveName() override { return TEXT("ShowdownBenchmarkCountingMalloc"); }
+
+    private:
+        static void Track(SIZE_T Count)
+        {
+            if (bCountAllocations)
+            {
+                ++CountedAllocations;
+                CountedBytes += Count;
+            }
+        }
+
+        FMalloc* Inner;
+    };
+
+    FCountingMalloc* AllocationCounter = nullptr;
+
+    FString GetBaselinePath()
+    {
+        return FPaths::GameSourceDir() / TEXT("ShowdownEditor/Private/Tests/ShowdownBenchmarkBaseline.json");
+    }
+
+    FString GetResultsPath()
+    {
+        return FPaths::ProjectSavedDir() / TEXT("Benchmarks/ShowdownBenchmarkResults.json");
+    }
+
+    TSharedPtr<FJsonObject> LoadJson(const FString& Path)
+    {
+        FString Contents;
+        TSharedPtr<FJsonObject> Object;
+        if (!FFileHelper::LoadFileToString(Contents, *Path) || !FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(Contents), Object) || !Object.IsValid())
+        {
+            Object = MakeShared<FJsonObject>();
+        }
+        if (!Object->HasTypedField<EJson::Object>(TEXT("Benchmarks")))
+        {
+            Object->SetObjectField(TEXT("Benchmarks"), MakeShared<FJsonObject>());
+        }
+        return Object;
+    }
+
+    void SaveJson(const FString& Path, const TSharedRef<FJsonObject>& Object)
+    {
+        FString Contents;
+        FJsonSerializer::Serialize(Object, TJsonWriterFactory<>::Create(&Contents));
+        FFileHelper::SaveStringToFile(Contents, *Path);
+    }
+
+    TSharedRef<FJsonObject> ToJson(const FShowdownBenchmarkResult& Result)
+    {
+        TSharedRef<FJsonObject> Object = MakeShared<FJsonObject>();
+        Object->SetNumberField(TEXT("Iterations"), Result.Iterations);
+        Object->SetNumberField(TEXT("MedianMicroseconds"), Result.MedianMicroseconds);
+        Object->SetNumberField(TEXT("MeanMicroseconds"), Result.MeanMicroseconds);
+        if (Result.bCountedAllocations)
+        {
+            Object->SetNumberField(TEXT("AllocationsPerCall"), Result.AllocationsPerCall);
+            Object->SetNumberField(TEXT("BytesPerCall"), Result.BytesPerCall);
+        }
+        return Object;
+    }
+
+    bool IsUpdatingBaseline()
+    {
+        return FParse::Param(FCommandLine::Get(), TEXT("ShowdownBenchUpdateBaseline"));
+    }
+
+    void Record(const FShowdownBenchmarkResult& Result)
+    {
+        static TSharedPtr<FJsonObject> Results = MakeShared<FJsonObject>();
+        if (!Results->HasField(TEXT("Benchmarks")))
+        {
+            Results->SetObjectField(TEXT("Benchmarks"), MakeShared<FJsonObject>());
+        }
+        Results->GetObjectField(TEXT("Benchmarks"))->SetObjectField(Result.Name, ToJson(Result));
+        SaveJson(GetResultsPath(), Results.ToSharedRef());
+
+        if (IsUpdatingBaseline())
+        {
+            TSharedPtr<FJsonObject> Baseline = LoadJson(GetBaselinePath());
+            Baseline->GetObjectField(TEXT("Benchmarks"))->SetObjectField(Result.Name, ToJson(Result));
+            SaveJson(GetBaselinePath(), Baseline.ToSharedRef());
+        }
+    }
+
+    void CompareWithBaseline(FAutomationTestBase& Test, const FShowdownBenchmarkResult& Result)
+    {
+        if (IsUpdatingBaseline())
+        {
+            return;
+        }
+
+        static TSharedPtr<FJsonObject> Baseline = LoadJson(GetBaselinePath());
+
+        // Baselines are recorded on the reference machine, so until then a missing entry only warns. Strict runs,
+        // which gate on the baseline, fail instead of passing silently.
+        const TSharedPtr<FJsonObject>* Entry = nullptr;
+        if (!Baseline->GetObjectField(TEXT("Benchmarks"))->TryGetObjectField(Result.Name, Entry))
+        {
+            const FString Message = FString::Printf(TEXT("%s has no baseline entry. Run with -ShowdownBenchUpdateBaseline and commit %s."), *Result.Name, *GetBaselinePath());
+            if (FParse::Param(FCommandLine::Get(), TEXT("ShowdownBenchStrict")))
+            {
+                Test.AddError(Message);
+            }
+            else
+            {
+                Test.AddWarning(Message);
+            }
+            return;
+        }
+
+        const double BaselineMedian = (*Entry)->GetNumberField(TEXT("MedianMicroseconds"));
+
+        TArray<FString> Regressions;
+        if (Result.MedianMicroseconds > BaselineMedian * (1.0 + TimeTolerance))
+        {
+            Regressions.Add(FString::Printf(TEXT("median %.2f us vs %.2f us baseline"), Result.MedianMicroseconds, BaselineMedian));
+        }
+
+        double BaselineAllocations = 0.0;
+        if (!Result.bCountedAllocations)
+        {
+            Test.AddWarning(FString::Printf(TEXT("%s: allocations not compared, run with -ShowdownBenchAllocs."), *Result.Name));
+        }
+        else if ((*Entry)->TryGetNumberField(TEXT("AllocationsPerCall"), BaselineAllocations) && Result.AllocationsPerCall > BaselineAllocations + 0.5)
+        {
+            Regressions.Add(FString::Printf(TEXT("%.1f allocations per call vs %.1f baseline"), Result.AllocationsPerCall, BaselineAllocations));
+        }
+
+        if (Regressions.Num() == 0)
+        {
+            return;
+        }
+
+        const FString Message = FString::Printf(TEXT("%s regressed: %s"), *Result.Name, *FString::Join(Regressions, TEXT(", ")));
+        if (FParse::Param(FCommandLine::Get(), TEXT("ShowdownBenchStrict")))
+        {
+            Test.AddError(Message);
+        }
+        else
+        {
+            Test.AddWarning(Message);
+        }
+    }
+}
+
+void ShowdownBenchmark::InstallAllocationCounter()
+{
+    if (AllocationCounter || !FParse::Param(FCommandLine::Get(), TEXT("ShowdownBenchAllocs")))
+    {
+        return;
+    }
+
+    AllocationCounter = new FCountingMalloc(GMalloc);
+    FPlatformAtomics::InterlockedExchangePtr(reinterpret_cast<void**>(&GMalloc), AllocationCounter);
+}
+
+FShowdownBenchmarkResult ShowdownBenchmark::Run(FAutomationTestBase& Test, const FString& Name, int32 Iterations, TFunctionRef<void()> Body)
+{
+    Iterations = FMath::Max(1, Iterations);
+    Body();
+
+    TArray<double> Microseconds;
+    Microseconds.Reserve(Iterations);
+
+    for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+    {
+        const uint64 StartCycles = FPlatformTime::Cycles64();
+        Body();
+        Microseconds.Add(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles) * 1000.0);
+    }
+
+    FShowdownBenchmarkResult Result;
+    Result.Name = Name;
+    Result.Iterations = Iterations;
+
+    // Allocations are counted in a separate, untimed pass so the counting never shows up in the times.
+    if (AllocationCounter)
+    {
+        CountedAllocations = 0;
+        CountedBytes = 0;
+        bCountAllocations = true;
+        for (int32 Iteration = 0; Iteration < Iterations; ++Iteration)
+        {
+            Body();
+        }
+        bCountAllocations = false;
+
+        Result.bCountedAllocations = true;
+        Result.AllocationsPerCall = double(CountedAllocations) / Iterations;
+        Result.BytesPerCall = double(CountedBytes) / Iterations;
+    }
+
+    double Total = 0.0;
+    for (const double Value : Microseconds)
+    {
+        Total += Value;
+    }
+    Result.MeanMicroseconds = Total / Iterations;
+    Microseconds.Sort();
+    Result.MedianMicroseconds = Microseconds[Iterations / 2];
+
+    Test.AddInfo(FString::Printf(TEXT("%s: median %.2f us, mean %.2f us, %.1f allocations (%.0f bytes) per call over %d iterations"),
+        *Name, Result.MedianMicroseconds, Result.MeanMicroseconds, Result.AllocationsPerCall, Result.BytesPerCall, Iterations));
+
+    CompareWithBaseline(Test, Result);
+    Record(Result);
+    return Result;
+}
+
+FString ShowdownBenchmark::WriteCaptureImage(int32 Width, int32 Height, EImageFormat Format)
+{
+    const FString Directory = FPaths::ConvertRelativePathToFull(FPaths::ProjectSavedDir() / TEXT("Benchmarks/Inputs/"));
+    const FString Extension = Format == EImageFormat::JPEG ? TEXT("jpg") : TEXT("png");
+    const FString FilePath = Directory + FString::Printf(TEXT("Capture_%dx%d.%s"), Width, Height, *Extension);
+    if (FPaths::FileExists(FilePath))
+    {
+        return FilePath;
+    }
+
+    TArray<FColor> Pixels;
+    Pixels.SetNumUninitialized(Width * Height);
+    FRandomStream Random(Width ^ Height);
+    for (int32 y = 0; y < Height; ++y)
+    {
+        for (int32 x = 0; x < Width; ++x)
+        {
+            const uint8 Noise = uint8(Random.RandRange(0, 15));
+            Pixels[y * Width + x] = FColor(uint8(x * 255 / Width) + Noise, uint8(y * 255 / Height) + Noise, uint8(128 + Noise), 255);
+        }
+    }
+
+    IImageWrapperModule& ImageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+    TSharedPtr<IImageWrapper> ImageWrapper = ImageWrapperModule.CreateImageWrapper(Format);
+    if (!ImageWrapper.IsValid() || !ImageWrapper->SetRaw(Pixels.GetData(), Pixels.Num() * sizeof(FColor), Width, Height, ERGBFormat::BGRA, 8))
+    {
+        return FString();
+    }
+
+    FPlatformFileManager::Get().GetPlatformFile().CreateDirectoryTree(*Directory);
+    const TArray64<uint8>& Compressed = ImageWrapper->GetCompressed(Format == EImageFormat::JPEG ? 90 : 0);
+    return FFileHelper::SaveArrayToFile(Compressed, *FilePath) ? FilePath : FString();
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "IImageWrapper.h"
+
+class FAutomationTestBase;
+
+struct FShowdownBenchmarkResult
+{
+    FString Name;
+    int32 Iterations = 0;
+    double MedianMicroseconds = 0.0;
+    double MeanMicroseconds = 0.0;
+    bool bCountedAllocations = false;
+    double AllocationsPerCall = 0.0;
+    double BytesPerCall = 0.0;
+};
+
+/**
+ * Timing and allocation tracking shared by the Showdown benchmark automation tests.
+ *
+ * Results are written to Saved/Benchmarks/ShowdownBenchmarkResults.json and compared against
+ * Source/ShowdownEditor/Private/Tests/ShowdownBenchmarkBaseline.json. Regressions and benchmarks missing from the
+ * baseline are reported as warnings, or as errors when -ShowdownBenchStrict is on the command line.
+ * -ShowdownBenchUpdateBaseline rewrites the baseline with the current numbers.
+ */
+namespace ShowdownBenchmark
+{
+    /**
+     * With -ShowdownBenchAllocs on the command line, wraps GMalloc in an allocation counting proxy. Called once from
+     * module startup; the proxy stays installed for the rest of the process.
+     */
+    void InstallAllocationCounter();
+
+    /**
+     * Runs Body once to warm up, then Iterations more times while timing each call. When the allocation counter is
+     * installed, runs Iterations more untimed calls counting the allocations made on the calling thread. Work the
+     * body hands off to other threads is not counted.
+     */
+    FShowdownBenchmarkResult Run(FAutomationTestBase& Test, const FString& Name, int32 Iterations, TFunctionRef<void()> Body);
+
+    /**
+     * Writes a noisy gradient image of the given size to Saved/Benchmarks/Inputs, so compression behaves like a real capture.
+     * @return The full path of the written file, or an empty string on failure.
+     */
+    FString WriteCaptureImage(int32 Width, int32 Height, EImageFormat Format);
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -0,0 +1,177 @@
+#include "ShowdownBenchmarkHarness.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "ShowdownEditor.h"
+#include "ShowdownEditorBlueprintLibrary.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/SkeletalMesh.h"
+#include "Engine/World.h"
+#include "HAL/FileManager.h"
+#include "Misc/AutomationTest.h"
+#include "Misc/Paths.h"
+#include "PrintStringBPLib.h"
+#include "PSOCacheBPLib.h"
+#include "SkeletalUtilitiesBPLib.h"
+
+// Run headless with:
+//   UnrealEditor-Cmd Showdown.uproject -nullrhi -unattended -nosplash -ShowdownBenchAllocs -ExecCmds="Automation RunTests Showdown.Benchmarks; Quit"
+
+#define SHOWDOWN_BENCHMARK_FLAGS (EAutomationTestFlags::EditorContext | EAutomationTestFlags::PerfFilter)
+
+namespace
+{
+    struct FCaptureSize
+    {
+        int32 Width;
+        int32 Height;
+    };
+
+    const FCaptureSize CaptureSizes[] = { { 1920, 1080 }, { 2560, 1440 }, { 3840, 2160 } };
+
+    FString MakeLogLine(int32 Length)
+    {
+        FString Line;
+        Line.Reserve(Length);
+        for (int32 Index = 0; Index < Length; ++Index)
+        {
+            Line.AppendChar(TCHAR('a' + Index % 26));
+        }
+        return Line;
+    }
+
+    FString MakeMultiLineLog(int32 Lines, int32 LineLength)
+    {
+        TArray<FString> AllLines;
+        for (int32 Index = 0; Index < Lines; ++Index)
+        {
+            AllLines.Add(MakeLogLine(LineLength));
+        }
+        return FString::Join(AllLines, TEXT("\n"));
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShowdownDebugLogBenchmark, "Showdown.Benchmarks.DebugLog", SHOWDOWN_BENCHMARK_FLAGS)
+
+bool FShowdownDebugLogBenchmark::RunTest(const FString& Parameters)
+{
+    const FString Short = MakeLogLine(64);
+    const FString Long = MakeLogLine(4096);
+    const FString MultiLine = MakeMultiLineLog(256, 120);
+
+    ShowdownBenchmark::Run(*this, TEXT("DebugLog.Short64"), 1000, [&Short]() { UPrintStringBPLib::DebugLog(Short); });
+    ShowdownBenchmark::Run(*this, TEXT("DebugLog.SingleLine4K"), 200, [&Long]() { UPrintStringBPLib::DebugLog(Long); });
+    ShowdownBenchmark::Run(*this, TEXT("DebugLog.MultiLine256x120"), 50, [&MultiLine]() { UPrintStringBPLib::DebugLog(MultiLine); });
+
+    // The editor logs through UE_LOG, so the runs above do not cover the logcat path used on Quest. Time the line
+    // splitting it shares with a sink that does nothing; the cost of __android_log_print itself is not measured.
+    int32 LineCount = 0;
+    auto CountLine = [&LineCount](const TCHAR* Line) { ++LineCount; };
+    ShowdownBenchmark::Run(*this, TEXT("DebugLog.SplitLines.Short64"), 1000, [&Short, &CountLine]() { UPrintStringBPLib::ForEachLogLine(Short, CountLine); });
+    ShowdownBenchmark::Run(*this, TEXT("DebugLog.SplitLines.SingleLine4K"), 200, [&Long, &CountLine]() { UPrintStringBPLib::ForEachLogLine(Long, CountLine); });
+    ShowdownBenchmark::Run(*this, TEXT("DebugLog.SplitLines.MultiLine256x120"), 50, [&MultiLine, &CountLine]() { UPrintStringBPLib::ForEachLogLine(MultiLine, CountLine); });
+    TestTrue(TEXT("Log lines were split"), LineCount > 0);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShowdownCreateMaskedImageBenchmark, "Showdown.Benchmarks.CreateMaskedImage", SHOWDOWN_BENCHMARK_FLAGS)
+
+bool FShowdownCreateMaskedImageBenchmark::RunTest(const FString& Parameters)
+{
+    for (const FCaptureSize& Size : CaptureSizes)
+    {
+        const FString CapturePath = ShowdownBenchmark::WriteCaptureImage(Size.Width, Size.Height, EImageFormat::PNG);
+        if (!TestFalse(TEXT("Benchmark capture was written"), CapturePath.IsEmpty()))
+        {
+            return false;
+        }
+
+        const int32 Iterations = 5;
+        TArray<FString> MaskedPaths;
+        MaskedPaths.Reserve(Iterations + 1);
+
+        ShowdownBenchmark::Run(*this, FString::Printf(TEXT("CreateMaskedImage.%dx%d"), Size.Width, Size.Height), Iterations,
+            [&CapturePath, &MaskedPaths]() { MaskedPaths.Add(CreateMaskedImage(CapturePath)); });
+
+        for (const FString& MaskedPath : MaskedPaths)
+        {
+            TestFalse(TEXT("Masked image was written"), MaskedPath.IsEmpty());
+            IFileManager::Get().Delete(*MaskedPath, false, false, true);
+        }
+    }
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShowdownLoadTextureFromFileBenchmark, "Showdown.Benchmarks.LoadTextureFromFile", SHOWDOWN_BENCHMARK_FLAGS)
+
+bool FShowdownLoadTextureFromFileBenchmark::RunTest(const FString& Parameters)
+{
+    for (const EImageFormat Format : { EImageFormat::PNG, EImageFormat::JPEG })
+    {
+        for (const FCaptureSize& Size : CaptureSizes)
+        {
+            const FString CapturePath = ShowdownBenchmark::WriteCaptureImage(Size.Width, Size.Height, Format);
+            if (!TestFalse(TEXT("Benchmark capture was written"), CapturePath.IsEmpty()))
+            {
+                return false;
+            }
+
+            UTexture2D* LastTexture = nullptr;
+            ShowdownBenchmark::Run(*this, FString::Printf(TEXT("LoadTextureFromFile.%s.%dx%d"), *FPaths::GetExtension(CapturePath), Size.Width, Size.Height), 5,
+                [&CapturePath, &LastTexture]() { LastTexture = UShowdownEditorBlueprintLibrary::LoadTextureFromFile(CapturePath); });
+            TestNotNull(TEXT("Texture was created"), LastTexture);
+        }
+    }
+
+    CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShowdownSetCPUSkinningBenchmark, "Showdown.Benchmarks.SetCPUSkinning", SHOWDOWN_BENCHMARK_FLAGS)
+
+bool FShowdownSetCPUSkinningBenchmark::RunTest(const FString& Parameters)
+{
+    ShowdownBenchmark::Run(*this, TEXT("SetCPUSkinning.NullTarget"), 1000, []() { USkeletalUtilitiesBPLib::SetCPUSkinning(true, nullptr); });
+
+    USkeletalMesh* Mesh = LoadObject<USkeletalMesh>(nullptr, TEXT("/Engine/EngineMeshes/SkeletalCube.SkeletalCube"));
+    if (!Mesh)
+    {
+        AddWarning(TEXT("SkeletalCube engine mesh not found, skipping the registered component case."));
+        return true;
+    }
+
+    // Toggling only does real work when the component has render state to recreate, so give it a world.
+    UWorld* World = UWorld::CreateWorld(EWorldType::Editor, false);
+    FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Editor);
+    WorldContext.SetCurrentWorld(World);
+
+    USkeletalMeshComponent* Component = NewObject<USkeletalMeshComponent>(World);
+    Component->SetSkinnedAssetAndUpdate(Mesh);
+    Component->RegisterComponentWithWorld(World);
+
+    bool bEnabled = false;
+    ShowdownBenchmark::Run(*this, TEXT("SetCPUSkinning.Toggle"), 100, [Component, &bEnabled]()
+        {
+            bEnabled = !bEnabled;
+            USkeletalUtilitiesBPLib::SetCPUSkinning(bEnabled, Component);
+        });
+
+    Component->UnregisterComponent();
+    GEngine->DestroyWorldContext(World);
+    World->DestroyWorld(false);
+    CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FShowdownPSOCacheReadyBenchmark, "Showdown.Benchmarks.PSOCacheReady", SHOWDOWN_BENCHMARK_FLAGS)
+
+bool FShowdownPSOCacheReadyBenchmark::RunTest(const FString& Parameters)
+{
+    ShowdownBenchmark::Run(*this, TEXT("PSOCacheReady"), 1000, []() { UPSOCacheBPLib::PSOCacheReady(); });
+    return true;
+}
+
+#undef SHOWDOWN_BENCHMARK_FLAGS
+
+#endif // WITH_DEV_AUTOMATION_TESTS
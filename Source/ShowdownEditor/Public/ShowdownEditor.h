@@ -1,6 +1,7 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
 #include "Modules/ModuleInterface.h"
 #include "Provider/Types/ImageTypes.h"
 #include "Provider/Types/CommonTypes.h"
@@ -11,6 +12,12 @@ class UOpenAIProvider;
 
 //DECLARE_LOG_CATEGORY_EXTERN(LogShowdownEditor, Log, All);
 
+/** LLM tag for ShowdownEditor allocations, reported under Showdown/ShowdownEditor. */
+LLM_DECLARE_TAG(Showdown_Editor);
+
+/** Writes a copy of the PNG at OriginalImagePath with a transparent 1024x1024 square in the centre, returning the new file path or an empty string on failure. */
+FString CreateMaskedImage(const FString& OriginalImagePath);
+
 class FShowdownEditorModule : public IModuleInterface
 {
 public:
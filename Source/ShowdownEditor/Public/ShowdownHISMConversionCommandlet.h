@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ShowdownHISMConversionCommandlet.generated.h"
+
+/**
+ * Finds static mesh actors that share the same mesh and materials and folds each set into a single
+ * hierarchical instanced static mesh component, then reports the estimated draw call and primitive savings per map.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd Showdown.uproject -run=ShowdownHISMConversion [-Maps=/Game/Maps/Showdown_P+/Game/Maps/EnvironmentMap]
+ *       [-MinInstances=3] [-CullScreenSize=0.01] [-MinCullDistance=1500] [-Save]
+ *
+ * Without -Save the commandlet only writes the report, so the proposed change can be reviewed before any map is touched.
+ * Actors tagged NoHISM, or referenced by other actors, the level script or a level sequence, are left alone.
+ */
+UCLASS()
+class UShowdownHISMConversionCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UShowdownHISMConversionCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ShowdownRailVisibilityCommandlet.generated.h"
+
+/**
+ * Bakes UShowdownRailVisibilityData for the rail camera. Samples the camera location along each level sequence
+ * (following shot/sub-sequence sections, camera cuts, transform tracks and camera rig rails), then for every time
+ * segment raycasts on the CPU from the camera and a head-sized box around it to each static primitive's bounds.
+ * Head rotation is not constrained, so visibility is tested in every direction. Movable primitives are never culled.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd Showdown.uproject -run=ShowdownRailVisibility -nullrhi [-Map=/Game/Maps/Showdown_P]
+ *       [-Sequences=/Game/MatineeSequences/SequenceMaster+/Game/MatineeSequences/SlomoRail_LevelSequence]
+ *       [-OutputPath=/Game/Visibility] [-SegmentSeconds=0.5] [-SamplesPerSegment=3] [-HeadRadius=40] [-SweepRays=2048]
+ */
+UCLASS()
+class UShowdownRailVisibilityCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UShowdownRailVisibilityCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ShowdownShaderPermutationCommandlet.generated.h"
+
+/**
+ * Counts the shader permutations every material would compile for a target shader format, broken down per material
+ * and per vertex factory, and attributes them to the project settings and material usage flags that enable them.
+ * Only the shader map layouts are evaluated, nothing is compiled, so it runs offline on any editor platform.
+ *
+ * Usage:
+ *   UnrealEditor-Cmd Showdown.uproject -run=ShowdownShaderPermutations [-ShaderFormats=SF_VULKAN_ES31_ANDROID+PCD3D_SM5]
+ *       [-Paths=/Game] [-AvgShaderBytes=6144] [-AvgCompileMs=150]
+ *
+ * Byte and compile time savings are estimates derived from the averages above, not from compiled output.
+ */
+UCLASS()
+class UShowdownShaderPermutationCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UShowdownShaderPermutationCommandlet();
+
+    virtual int32 Main(const FString& Params) override;
+};
@@ -28,12 +28,21 @@ public class ShowdownEditor : ModuleRules
                 "ShowdownQuest",
                 "OpenAI",
                 "HTTP",
+                "Json",
                 "ImageWrapper",
                 "RenderCore",
+                "RHI",
                 "UMG",
                 "UMGEditor",
                 "Blutility",
-                "EditorSubsystem"
+                "EditorSubsystem",
+                "AssetRegistry",
+                "LevelSequence",
+                "MovieScene",
+                "MovieSceneTracks",
+                "UniversalObjectLocator",
+                "CinematicCamera",
+                "SourceControl"
             }
         );
     }
@@ -11,5 +11,18 @@ public class ShowdownQuestTarget : TargetRules
 		DefaultBuildSettings = BuildSettingsVersion.V5;
 		IncludeOrderVersion = EngineIncludeOrderVersion.Latest;
 		ExtraModuleNames.AddRange( new string[] { "ShowdownQuest" } );
+
+		if (Configuration == UnrealTargetConfiguration.Development || Configuration == UnrealTargetConfiguration.Test)
+		{
+			// The memory budget monitor measures categories through LLM's per-asset tags, which are compiled out by default.
+			bOverrideBuildEnvironment = true;
+			GlobalDefinitions.Add("LLM_ALLOW_ASSETS_TAGS=1");
+		}
+
+		if (Configuration == UnrealTargetConfiguration.Test)
+		{
+			// Keep the Low-Level Memory tracker in Test builds so the memory budget monitor works on device with -llm.
+			GlobalDefinitions.Add("ALLOW_LOW_LEVEL_MEM_TRACKER_IN_TEST=1");
+		}
 	}
 }
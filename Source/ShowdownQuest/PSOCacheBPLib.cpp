@@ -3,9 +3,12 @@
 
 #include "PSOCacheBPLib.h"
 #include "ShaderPipelineCache.h"
+#include "ShowdownMemory.h"
 
 bool SHOWDOWNQUEST_API UPSOCacheBPLib::PSOCacheReady()
 {
+	LLM_SCOPE_BYTAG(Showdown_Quest);
+
 	uint32 remaining = FShaderPipelineCache::NumPrecompilesRemaining();
 
 	if (remaining > 0)
@@ -13,7 +13,8 @@ UCLASS()
 class SHOWDOWNQUEST_API UPSOCacheBPLib : public UBlueprintFunctionLibrary
 {
 	GENERATED_BODY()
-	
+
+public:
 	UFUNCTION(BlueprintCallable, Category = "AAA")
 	static bool PSOCacheReady();
 };
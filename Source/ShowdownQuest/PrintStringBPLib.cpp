@@ -2,6 +2,7 @@
 
 
 #include "PrintStringBPLib.h"
+#include "ShowdownMemory.h"
 
 #if PLATFORM_ANDROID
 	#include <android/log.h>
@@ -11,17 +12,30 @@ DEFINE_LOG_CATEGORY_STATIC(LogPrintStringBPLib, Display, All);
 
 void SHOWDOWNQUEST_API UPrintStringBPLib::DebugLog(const FString& logString)
 {
+	LLM_SCOPE_BYTAG(Showdown_Quest);
+
+	ForEachLogLine(logString, [](const TCHAR* Line)
+	{
 #if PLATFORM_ANDROID
-	// Duplicated string logic from UE4_LOG. This will output in shipping builds.
-	const int MAX_LOG_LENGTH = 4096;
+		// Goes straight to logcat, so this will output in shipping builds.
+		__android_log_print(ANDROID_LOG_INFO, "Showdown", "%s", TCHAR_TO_UTF8(Line));
+#else
+		UE_LOG(LogPrintStringBPLib, Display, TEXT("%s"), Line);
+#endif
+	});
+}
+
+void SHOWDOWNQUEST_API UPrintStringBPLib::ForEachLogLine(const FString& logString, TFunctionRef<void(const TCHAR* Line)> Sink)
+{
+	// Duplicated string logic from UE4_LOG.
 	// not static since may be called by different threads
-	wchar_t MessageBuffer[MAX_LOG_LENGTH];
+	TCHAR MessageBuffer[MaxLogLineLength];
 
 	const TCHAR* SourcePtr = *logString;
 	while (*SourcePtr)
 	{
-		wchar_t* WritePtr = MessageBuffer;
-		int32 RemainingSpace = MAX_LOG_LENGTH;
+		TCHAR* WritePtr = MessageBuffer;
+		int32 RemainingSpace = MaxLogLineLength;
 		while (*SourcePtr && --RemainingSpace > 0)
 		{
 			if (*SourcePtr == TEXT('\n'))
@@ -31,13 +45,10 @@ void SHOWDOWNQUEST_API UPrintStringBPLib::DebugLog(const FString& logString)
 			}
 			else
 			{
-				*WritePtr++ = static_cast<wchar_t>(*SourcePtr++);
+				*WritePtr++ = *SourcePtr++;
 			}
 		}
-		*WritePtr = '\0';
-		__android_log_print(ANDROID_LOG_INFO, "Showdown", "%ls", MessageBuffer);
+		*WritePtr = TEXT('\0');
+		Sink(MessageBuffer);
 	}
-#else
-	UE_LOG(LogPrintStringBPLib, Display, TEXT("%s"), *logString);
-#endif
 }
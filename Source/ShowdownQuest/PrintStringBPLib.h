@@ -14,7 +14,16 @@ class SHOWDOWNQUEST_API UPrintStringBPLib : public UBlueprintFunctionLibrary
 {
 	GENERATED_BODY()
 
+public:
 	UFUNCTION(BlueprintCallable, Category = "AAA")
 	static void DebugLog(const FString& logString);
+
+	/**
+	 * Splits logString at newlines and at MaxLogLineLength characters, and hands each line to Sink. This is how
+	 * DebugLog feeds the platform log; the pointer is only valid during the call.
+	 */
+	static void ForEachLogLine(const FString& logString, TFunctionRef<void(const TCHAR* Line)> Sink);
+
+	static constexpr int32 MaxLogLineLength = 4096;
 	
 };
@@ -0,0 +1,7 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates. All rights reserved.
+
+
+#include "ShowdownMemory.h"
+
+LLM_DEFINE_TAG(Showdown);
+LLM_DEFINE_TAG(Showdown_Quest, TEXT("ShowdownQuest"), TEXT("Showdown"));
@@ -0,0 +1,25 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/LowLevelMemTracker.h"
+#include "ShowdownMemory.generated.h"
+
+/**
+ * Asset categories with their own memory budget. Each one maps to a content folder (see
+ * UShowdownMemoryBudgetSubsystem::ContentPaths) and is measured from LLM's per-asset tag set.
+ */
+UENUM(BlueprintType)
+enum class EShowdownMemoryCategory : uint8
+{
+	Characters,
+	Vehicles,
+	Effects,
+	Environment,
+};
+
+// LLM tags for the Showdown C++ modules. They show up under "Showdown" in stat LLMFULL and LLM csv captures
+// when running with -llm, and compile out entirely when ENABLE_LOW_LEVEL_MEM_TRACKER is 0.
+LLM_DECLARE_TAG_API(Showdown, SHOWDOWNQUEST_API);
+LLM_DECLARE_TAG_API(Showdown_Quest, SHOWDOWNQUEST_API);
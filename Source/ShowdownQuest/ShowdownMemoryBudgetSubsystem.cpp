@@ -0,0 +1,117 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates. All rights reserved.
+
+
+#include "ShowdownMemoryBudgetSubsystem.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShowdownMemory, Log, All);
+
+void UShowdownMemoryBudgetSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	if (!bEnabled || !IsMemoryTrackingActive())
+	{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER
+		if (bEnabled && FLowLevelMemTracker::IsEnabled())
+		{
+			UE_LOG(LogShowdownMemory, Warning, TEXT("Memory budget monitor needs the Assets tag set, run with -llmtagsets=Assets."));
+		}
+#endif
+		return;
+	}
+
+	PollHandle = FTSTicker::GetCoreTicker().AddTicker(FTickerDelegate::CreateUObject(this, &UShowdownMemoryBudgetSubsystem::Poll), PollIntervalSeconds);
+	UE_LOG(LogShowdownMemory, Log, TEXT("Memory budget monitor polling every %.1fs"), PollIntervalSeconds);
+}
+
+void UShowdownMemoryBudgetSubsystem::Deinitialize()
+{
+	if (PollHandle.IsValid())
+	{
+		FTSTicker::GetCoreTicker().RemoveTicker(PollHandle);
+		PollHandle.Reset();
+	}
+
+	Super::Deinitialize();
+}
+
+bool UShowdownMemoryBudgetSubsystem::IsMemoryTrackingActive()
+{
+#if ENABLE_LOW_LEVEL_MEM_TRACKER && LLM_ALLOW_ASSETS_TAGS
+	return FLowLevelMemTracker::IsEnabled() && FLowLevelMemTracker::Get().IsTagSetActive(ELLMTagSet::Assets);
+#else
+	return false;
+#endif
+}
+
+TArray<FShowdownMemoryCategoryUsage> UShowdownMemoryBudgetSubsystem::GetCategoryUsage() const
+{
+	LLM_SCOPE_BYTAG(Showdown_Quest);
+
+	TMap<EShowdownMemoryCategory, int64> UsedBytes;
+#if ENABLE_LOW_LEVEL_MEM_TRACKER && LLM_ALLOW_ASSETS_TAGS
+	if (IsMemoryTrackingActive())
+	{
+		// Asset tags are package names; charge each one to the category with a folder that contains it.
+		auto FindCategory = [this](const FString& PackageName) -> const EShowdownMemoryCategory*
+		{
+			for (const TPair<EShowdownMemoryCategory, FShowdownContentFolders>& Folders : ContentPaths)
+			{
+				for (const FString& Path : Folders.Value.Paths)
+				{
+					if (PackageName.StartsWith(Path) && PackageName.IsValidIndex(Path.Len()) && PackageName[Path.Len()] == TEXT('/'))
+					{
+						return &Folders.Key;
+					}
+				}
+			}
+			return nullptr;
+		};
+
+		TMap<FName, uint64> AssetAmounts;
+		FLowLevelMemTracker::Get().GetTrackedTagsNamesWithAmount(AssetAmounts, ELLMTracker::Default, ELLMTagSet::Assets);
+		for (const TPair<FName, uint64>& Pair : AssetAmounts)
+		{
+			if (const EShowdownMemoryCategory* Category = FindCategory(Pair.Key.ToString()))
+			{
+				UsedBytes.FindOrAdd(*Category) += Pair.Value;
+			}
+		}
+	}
+#endif
+
+	TArray<FShowdownMemoryCategoryUsage> Usage;
+	const UEnum* CategoryEnum = StaticEnum<EShowdownMemoryCategory>();
+	for (int32 Index = 0; Index < CategoryEnum->NumEnums() - 1; ++Index)
+	{
+		FShowdownMemoryCategoryUsage& Entry = Usage.AddDefaulted_GetRef();
+		Entry.Category = static_cast<EShowdownMemoryCategory>(CategoryEnum->GetValueByIndex(Index));
+		Entry.BudgetMB = BudgetsMB.FindRef(Entry.Category);
+		Entry.UsedMB = UsedBytes.FindRef(Entry.Category) / (1024.0f * 1024.0f);
+
+		Entry.bOverBudget = Entry.BudgetMB > 0.0f && Entry.UsedMB > Entry.BudgetMB;
+	}
+	return Usage;
+}
+
+bool UShowdownMemoryBudgetSubsystem::Poll(float DeltaTime)
+{
+	for (const FShowdownMemoryCategoryUsage& Entry : GetCategoryUsage())
+	{
+		if (!Entry.bOverBudget)
+		{
+			CategoriesOverBudget.Remove(Entry.Category);
+			continue;
+		}
+
+		bool bAlreadyOver = false;
+		CategoriesOverBudget.Add(Entry.Category, &bAlreadyOver);
+		if (!bAlreadyOver)
+		{
+			UE_LOG(LogShowdownMemory, Warning, TEXT("%s over memory budget: %.1f MB used of %.1f MB"),
+				*StaticEnum<EShowdownMemoryCategory>()->GetNameStringByValue(static_cast<int64>(Entry.Category)), Entry.UsedMB, Entry.BudgetMB);
+			OnBudgetExceeded.Broadcast(Entry.Category, Entry.UsedMB, Entry.BudgetMB);
+		}
+	}
+	return true;
+}
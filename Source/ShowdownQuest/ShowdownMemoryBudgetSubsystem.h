@@ -0,0 +1,89 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "ShowdownMemory.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "ShowdownMemoryBudgetSubsystem.generated.h"
+
+USTRUCT(BlueprintType)
+struct SHOWDOWNQUEST_API FShowdownMemoryCategoryUsage
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Memory")
+	EShowdownMemoryCategory Category = EShowdownMemoryCategory::Characters;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Memory")
+	float UsedMB = 0.0f;
+
+	/** Zero when no budget is configured for the category. */
+	UPROPERTY(BlueprintReadOnly, Category = "Memory")
+	float BudgetMB = 0.0f;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Memory")
+	bool bOverBudget = false;
+};
+
+/** Content folders whose packages count towards one memory category. */
+USTRUCT()
+struct SHOWDOWNQUEST_API FShowdownContentFolders
+{
+	GENERATED_BODY()
+
+	/** e.g. /Game/Character. Packages in subfolders count too. */
+	UPROPERTY(config)
+	TArray<FString> Paths;
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FShowdownMemoryBudgetExceededSignature, EShowdownMemoryCategory, Category, float, UsedMB, float, BudgetMB);
+
+/**
+ * Compares live memory usage of each Showdown asset category against the budgets set in DefaultGame.ini and
+ * broadcasts OnBudgetExceeded when a category goes over. A category's usage is the sum of LLM's asset tags for
+ * every package under its content folders, so it covers everything loaded from there (UObjects, textures, meshes,
+ * animation...) whichever thread allocated it. Polling only starts when bEnabled is set and the game runs with
+ * -llm -llmtagsets=Assets, so the monitor can stay in Test builds on device at no cost otherwise.
+ */
+UCLASS(config = Game)
+class SHOWDOWNQUEST_API UShowdownMemoryBudgetSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/** Current usage and budget for every category. Usage reads zero when LLM is not running. */
+	UFUNCTION(BlueprintCallable, Category = "Memory")
+	TArray<FShowdownMemoryCategoryUsage> GetCategoryUsage() const;
+
+	/** True when the Low-Level Memory tracker is compiled in with asset tags and was enabled with -llm -llmtagsets=Assets. */
+	UFUNCTION(BlueprintPure, Category = "Memory")
+	static bool IsMemoryTrackingActive();
+
+	/** Fires once when a category crosses its budget, and again only after it has dropped back under. */
+	UPROPERTY(BlueprintAssignable, Category = "Memory")
+	FShowdownMemoryBudgetExceededSignature OnBudgetExceeded;
+
+private:
+	bool Poll(float DeltaTime);
+
+	UPROPERTY(config)
+	bool bEnabled = false;
+
+	UPROPERTY(config)
+	float PollIntervalSeconds = 1.0f;
+
+	UPROPERTY(config)
+	TMap<EShowdownMemoryCategory, float> BudgetsMB;
+
+	/** Content folders of each category. A package is counted under the first category with a matching folder. */
+	UPROPERTY(config)
+	TMap<EShowdownMemoryCategory, FShowdownContentFolders> ContentPaths;
+
+	TSet<EShowdownMemoryCategory> CategoriesOverBudget;
+	FTSTicker::FDelegateHandle PollHandle;
+};
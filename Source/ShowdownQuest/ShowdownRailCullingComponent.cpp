@@ -0,0 +1,186 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates. All rights reserved.
+
+
+#include "ShowdownRailCullingComponent.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "LevelSequence.h"
+#include "LevelSequenceActor.h"
+#include "LevelSequencePlayer.h"
+#include "ShowdownMemory.h"
+#include "ShowdownRailVisibilityData.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogShowdownRailCulling, Log, All);
+
+UShowdownRailCullingComponent::UShowdownRailCullingComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.TickGroup = TG_PostUpdateWork;
+}
+
+void UShowdownRailCullingComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!VisibilityData)
+	{
+		UE_LOG(LogShowdownRailCulling, Warning, TEXT("%s has no visibility data, rail culling is off."), *GetPathName());
+		SetComponentTickEnabled(false);
+		return;
+	}
+
+	ResolvePrimitives();
+	LevelAddedHandle = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UShowdownRailCullingComponent::OnLevelAddedToWorld);
+}
+
+void UShowdownRailCullingComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	ApplySegment(INDEX_NONE);
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedHandle);
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UShowdownRailCullingComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	const ULevelSequencePlayer* Player = SequenceActor ? SequenceActor->GetSequencePlayer() : nullptr;
+	const bool bPlaying = Player && Player->IsPlaying() && IsPlayingBakedSequence();
+	const int32 Segment = bPlaying ? VisibilityData->FindSegment(Player->GetCurrentTime().AsSeconds(), CurrentSegment) : INDEX_NONE;
+
+	if (Segment != CurrentSegment)
+	{
+		ApplySegment(Segment);
+	}
+}
+
+void UShowdownRailCullingComponent::ResolvePrimitives()
+{
+	LLM_SCOPE_BYTAG(Showdown_Quest);
+
+	TMap<FString, int32> IndexByKey;
+	IndexByKey.Reserve(VisibilityData->Primitives.Num());
+	for (int32 Index = 0; Index < VisibilityData->Primitives.Num(); ++Index)
+	{
+		IndexByKey.Add(VisibilityData->Primitives[Index].MakeKey(), Index);
+	}
+
+	ResolvedPrimitives.SetNum(VisibilityData->Primitives.Num());
+
+	int32 NumResolved = 0;
+	for (ULevel* Level : GetWorld()->GetLevels())
+	{
+		for (AActor* Actor : Level->Actors)
+		{
+			if (!Actor)
+				continue;
+
+			TInlineComponentArray<UPrimitiveComponent*> Components(Actor);
+			for (UPrimitiveComponent* Component : Components)
+			{
+				if (const int32* Index = IndexByKey.Find(FShowdownRailPrimitive::MakeKey(Component)))
+				{
+					ResolvedPrimitives[*Index] = Component;
+				}
+			}
+		}
+	}
+
+	for (const TWeakObjectPtr<UPrimitiveComponent>& Primitive : ResolvedPrimitives)
+	{
+		NumResolved += Primitive.IsValid() ? 1 : 0;
+	}
+	UE_LOG(LogShowdownRailCulling, Log, TEXT("Resolved %d of %d baked primitives"), NumResolved, ResolvedPrimitives.Num());
+
+	// Reapply so components from a newly loaded level pick up the current segment.
+	const int32 Segment = CurrentSegment;
+	CurrentSegment = INDEX_NONE;
+	ApplySegment(Segment);
+}
+
+void UShowdownRailCullingComponent::OnLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	if (World == GetWorld())
+	{
+		ResolvePrimitives();
+	}
+}
+
+bool UShowdownRailCullingComponent::IsPlayingBakedSequence()
+{
+	const ULevelSequence* Sequence = SequenceActor->GetSequence();
+	if (bSequenceChecked && CheckedSequence.Get() == Sequence)
+	{
+		return Sequence && bCheckedSequenceIsBaked;
+	}
+
+	bSequenceChecked = true;
+	CheckedSequence = Sequence;
+	bCheckedSequenceIsBaked = Sequence && FSoftObjectPath(Sequence) == VisibilityData->Sequence;
+	if (!bCheckedSequenceIsBaked)
+	{
+		UE_LOG(LogShowdownRailCulling, Warning, TEXT("%s plays %s but %s was baked for %s, rail culling is off."), *SequenceActor->GetName(),
+			*GetNameSafe(Sequence), *VisibilityData->GetName(), *VisibilityData->Sequence.ToString());
+	}
+	return bCheckedSequenceIsBaked;
+}
+
+void UShowdownRailCullingComponent::SetOcclusionQueriesDisabled(bool bDisabled)
+{
+	IConsoleVariable* AllowOcclusionQueries = IConsoleManager::Get().FindConsoleVariable(TEXT("r.AllowOcclusionQueries"));
+	if (!AllowOcclusionQueries)
+		return;
+
+	if (bDisabled && PreviousAllowOcclusionQueries == INDEX_NONE)
+	{
+		PreviousAllowOcclusionQueries = AllowOcclusionQueries->GetInt();
+		AllowOcclusionQueries->Set(0, ECVF_SetByCode);
+	}
+	else if (!bDisabled && PreviousAllowOcclusionQueries != INDEX_NONE)
+	{
+		AllowOcclusionQueries->Set(PreviousAllowOcclusionQueries, ECVF_SetByCode);
+		PreviousAllowOcclusionQueries = INDEX_NONE;
+	}
+}
+
+void UShowdownRailCullingComponent::ApplySegment(int32 SegmentIndex)
+{
+	CurrentSegment = SegmentIndex;
+
+	// Dynamic occlusion still has to handle movable and unbaked primitives, so it is only off while a segment covers the view.
+	SetOcclusionQueriesDisabled(bDisableOcclusionQueries && VisibilityData && VisibilityData->Segments.IsValidIndex(SegmentIndex));
+
+	APlayerController* PlayerController = GetWorld() ? GetWorld()->GetFirstPlayerController() : nullptr;
+	if (!PlayerController)
+	{
+		HiddenComponents.Reset();
+		return;
+	}
+
+	if (HiddenComponents.Num() > 0)
+	{
+		const TSet<TWeakObjectPtr<UPrimitiveComponent>> PreviouslyHidden(HiddenComponents);
+		PlayerController->HiddenPrimitiveComponents.RemoveAll([&PreviouslyHidden](const TWeakObjectPtr<UPrimitiveComponent>& Component)
+			{
+				return PreviouslyHidden.Contains(Component);
+			});
+		HiddenComponents.Reset();
+	}
+
+	if (!VisibilityData || !VisibilityData->Segments.IsValidIndex(SegmentIndex))
+		return;
+
+	const FShowdownRailVisibilitySegment& Segment = VisibilityData->Segments[SegmentIndex];
+	for (int32 Index = 0; Index < ResolvedPrimitives.Num(); ++Index)
+	{
+		if (!Segment.IsVisible(Index) && ResolvedPrimitives[Index].IsValid())
+		{
+			HiddenComponents.Add(ResolvedPrimitives[Index]);
+		}
+	}
+	PlayerController->HiddenPrimitiveComponents.Append(HiddenComponents);
+}
@@ -0,0 +1,70 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "ShowdownRailCullingComponent.generated.h"
+
+class ALevelSequenceActor;
+class ULevel;
+class ULevelSequence;
+class UPrimitiveComponent;
+class UShowdownRailVisibilityData;
+class UWorld;
+
+/**
+ * Precomputed culling stage for the rail camera. While SequenceActor plays, looks up the baked visibility segment for
+ * the current sequence time and hides every baked primitive that cannot be seen from the camera path during that
+ * segment, through the first player controller's HiddenPrimitiveComponents. Nothing is hidden while the sequence is stopped.
+ */
+UCLASS(ClassGroup = (Rendering), meta = (BlueprintSpawnableComponent))
+class SHOWDOWNQUEST_API UShowdownRailCullingComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UShowdownRailCullingComponent();
+
+	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
+	/** Number of primitives hidden by the current segment. */
+	UFUNCTION(BlueprintPure, Category = "Rendering")
+	int32 GetNumCulledPrimitives() const { return HiddenComponents.Num(); }
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Rendering")
+	TObjectPtr<UShowdownRailVisibilityData> VisibilityData;
+
+	/** Actor playing the sequence the data was baked from. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Rendering")
+	TObjectPtr<ALevelSequenceActor> SequenceActor;
+
+	/**
+	 * Turn off dynamic occlusion queries while a baked segment is applied, since it already culls the static scene.
+	 * Queries stay on while the sequence is stopped.
+	 */
+	UPROPERTY(EditAnywhere, Category = "Rendering")
+	bool bDisableOcclusionQueries = true;
+
+private:
+	void ResolvePrimitives();
+	void OnLevelAddedToWorld(ULevel* Level, UWorld* World);
+	void ApplySegment(int32 SegmentIndex);
+	void SetOcclusionQueriesDisabled(bool bDisabled);
+
+	/** False, with a warning once per sequence, when SequenceActor plays something other than what the data was baked for. */
+	bool IsPlayingBakedSequence();
+
+	/** Live component for each entry of VisibilityData->Primitives, null until its level is loaded. */
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> ResolvedPrimitives;
+	TArray<TWeakObjectPtr<UPrimitiveComponent>> HiddenComponents;
+	int32 CurrentSegment = INDEX_NONE;
+	int32 PreviousAllowOcclusionQueries = INDEX_NONE;
+	FDelegateHandle LevelAddedHandle;
+	/** Last sequence IsPlayingBakedSequence checked, so the soft path is only compared when SequenceActor's sequence changes. */
+	TWeakObjectPtr<const ULevelSequence> CheckedSequence;
+	bool bSequenceChecked = false;
+	bool bCheckedSequenceIsBaked = false;
+};
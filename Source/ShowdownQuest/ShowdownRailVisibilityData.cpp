@@ -0,0 +1,44 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates. All rights reserved.
+
+
+#include "ShowdownRailVisibilityData.h"
+#include "Algo/BinarySearch.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "GameFramework/Actor.h"
+#include "Misc/PackageName.h"
+
+FString FShowdownRailPrimitive::MakeKey(const UPrimitiveComponent* Component)
+{
+	const AActor* Owner = Component->GetOwner();
+	const ULevel* Level = Owner ? Owner->GetLevel() : nullptr;
+	if (!Level)
+		return FString();
+
+	// PIE duplicates levels into UEDPIE_N_ packages; strip that so keys match the baked editor names.
+	const FString LevelName = FPackageName::GetShortName(UWorld::RemovePIEPrefix(Level->GetOutermost()->GetName()));
+	return FString::Printf(TEXT("%s.%s.%s"), *LevelName, *Owner->GetName(), *Component->GetName());
+}
+
+FString FShowdownRailPrimitive::MakeKey() const
+{
+	return FString::Printf(TEXT("%s.%s.%s"), *LevelName.ToString(), *ActorName.ToString(), *ComponentName.ToString());
+}
+
+int32 UShowdownRailVisibilityData::FindSegment(float Time, int32 Hint) const
+{
+	auto Contains = [this, Time](int32 Index)
+	{
+		return Segments.IsValidIndex(Index) && Time >= Segments[Index].StartTime && Time < Segments[Index].EndTime;
+	};
+
+	if (Contains(Hint))
+		return Hint;
+
+	if (Contains(Hint + 1))
+		return Hint + 1;
+
+	const int32 Index = Algo::UpperBoundBy(Segments, Time, &FShowdownRailVisibilitySegment::StartTime) - 1;
+	return Contains(Index) ? Index : INDEX_NONE;
+}
@@ -0,0 +1,84 @@
+// Copyright (c) Meta Platforms, Inc. and affiliates. All rights reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "ShowdownRailVisibilityData.generated.h"
+
+class UPrimitiveComponent;
+
+/**
+ * Identifies a baked primitive by level, actor and component name so it can be found again in PIE and packaged builds.
+ */
+USTRUCT()
+struct SHOWDOWNQUEST_API FShowdownRailPrimitive
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, Category = "Visibility")
+	FName LevelName;
+
+	UPROPERTY(VisibleAnywhere, Category = "Visibility")
+	FName ActorName;
+
+	UPROPERTY(VisibleAnywhere, Category = "Visibility")
+	FName ComponentName;
+
+	/** Builds the lookup key for a live component, matching the key of the primitive it was baked from. */
+	static FString MakeKey(const UPrimitiveComponent* Component);
+	FString MakeKey() const;
+};
+
+/**
+ * Primitives visible from anywhere the camera can be during [StartTime, EndTime), one bit per entry of
+ * UShowdownRailVisibilityData::Primitives.
+ */
+USTRUCT()
+struct SHOWDOWNQUEST_API FShowdownRailVisibilitySegment
+{
+	GENERATED_BODY()
+
+	UPROPERTY(VisibleAnywhere, Category = "Visibility")
+	float StartTime = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, Category = "Visibility")
+	float EndTime = 0.0f;
+
+	UPROPERTY(VisibleAnywhere, Category = "Visibility")
+	FName ShotName;
+
+	UPROPERTY()
+	TArray<uint32> VisibleBits;
+
+	bool IsVisible(int32 PrimitiveIndex) const
+	{
+		const int32 Word = PrimitiveIndex / 32;
+		return !VisibleBits.IsValidIndex(Word) || (VisibleBits[Word] & (1u << (PrimitiveIndex % 32))) != 0;
+	}
+};
+
+/**
+ * Per-time-segment visible primitive sets baked along a level sequence's camera path by the ShowdownRailVisibility
+ * commandlet, and applied at runtime by UShowdownRailCullingComponent.
+ */
+UCLASS()
+class SHOWDOWNQUEST_API UShowdownRailVisibilityData : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/** Index of the segment containing Time, or INDEX_NONE outside the baked range. Hint is the last result, since time mostly moves forward. */
+	int32 FindSegment(float Time, int32 Hint = INDEX_NONE) const;
+
+	/** The level sequence the camera path was sampled from. */
+	UPROPERTY(VisibleAnywhere, Category = "Visibility")
+	FSoftObjectPath Sequence;
+
+	UPROPERTY(VisibleAnywhere, Category = "Visibility")
+	TArray<FShowdownRailPrimitive> Primitives;
+
+	/** Sorted by StartTime, without gaps. */
+	UPROPERTY(VisibleAnywhere, Category = "Visibility")
+	TArray<FShowdownRailVisibilitySegment> Segments;
+};
@@ -2,6 +2,7 @@
 
 
 #include "SkeletalUtilitiesBPLib.h"
+#include "ShowdownMemory.h"
 #include "Components/SkeletalMeshComponent.h" 
 
 #if PLATFORM_ANDROID
@@ -12,6 +13,8 @@ DEFINE_LOG_CATEGORY_STATIC(LogPrintStringBPLib, Display, All);
 
 void SHOWDOWNQUEST_API USkeletalUtilitiesBPLib::SetCPUSkinning(bool bEnabled, USkeletalMeshComponent * target)
 {
+	LLM_SCOPE_BYTAG(Showdown_Quest);
+
 	if (!target)
 		return;
 
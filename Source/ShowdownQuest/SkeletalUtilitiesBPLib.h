@@ -14,6 +14,7 @@ class SHOWDOWNQUEST_API USkeletalUtilitiesBPLib : public UBlueprintFunctionLibra
 {
 	GENERATED_BODY()
 
+public:
 	UFUNCTION(BlueprintCallable, Category = "Skeletal")
 	static void SetCPUSkinning(bool bEnabled, USkeletalMeshComponent * target);
 	